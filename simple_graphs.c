@@ -1,542 +1,7467 @@
 #include <Python.h>
 #include "structmember.h"
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define POPCOUNT64(x) ((int)__popcnt64(x))
+static __inline int CTZ64(uint64_t x) {
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return (int)index;
+}
+#else
+#define POPCOUNT64(x) __builtin_popcountll(x)
+#define CTZ64(x) __builtin_ctzll(x)
+#endif
+
+// cieki wektorowe s kompilowane tylko wtedy, gdy kompilator ma wczone
+// odpowiednie rozszerzenia (np. -mavx2 / -mavx512vpopcntdq albo /arch:AVX2).
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Zwraca liczb bitw ustawionych jednoczenie w a i b (wiersze o dugoci words sw).
+static uint64_t popcountAnd(const uint64_t* a, const uint64_t* b, int words) {
+    uint64_t total = 0;
+    int i = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    __m512i acc = _mm512_setzero_si512();
+    for (; i + 8 <= words; i += 8) {
+        __m512i x = _mm512_and_si512(_mm512_loadu_si512((const void*)(a + i)), _mm512_loadu_si512((const void*)(b + i)));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(x));
+    }
+    total += (uint64_t)_mm512_reduce_add_epi64(acc);
+#elif defined(__AVX2__)
+    // Zliczanie powek bajtw przez tablic w rejestrze (vpshufb) i sumowanie przez vpsadbw
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i lowMask = _mm256_set1_epi8(0x0F);
+    __m256i acc = _mm256_setzero_si256();
+    for (; i + 4 <= words; i += 4) {
+        __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + i)), _mm256_loadu_si256((const __m256i*)(b + i)));
+        __m256i low = _mm256_and_si256(x, lowMask);
+        __m256i high = _mm256_and_si256(_mm256_srli_epi16(x, 4), lowMask);
+        __m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(lookup, low), _mm256_shuffle_epi8(lookup, high));
+        acc = _mm256_add_epi64(acc, _mm256_sad_epu8(counts, _mm256_setzero_si256()));
+    }
+    total += (uint64_t)_mm256_extract_epi64(acc, 0) + (uint64_t)_mm256_extract_epi64(acc, 1) +
+             (uint64_t)_mm256_extract_epi64(acc, 2) + (uint64_t)_mm256_extract_epi64(acc, 3);
+#endif
+
+    for (; i < words; i++) {
+        total += (uint64_t)POPCOUNT64(a[i] & b[i]);
+    }
+    return total;
+}
+
+// Liczy trjkty w grafie zapisanym jako n wierszy bitowych po words sw (bez ptli).
+// Kady trjkt jest zliczany raz dla kadej ze swoich trzech krawdzi.
+static long long countTriangles(const uint64_t* rows, int n, int words) {
+    uint64_t total = 0;
+
+    for (int u = 0; u < n; u++) {
+        const uint64_t* row = rows + (size_t)u * words;
+        for (int w = u / 64; w < words; w++) {
+            uint64_t higher = row[w];
+            if (w == u / 64) {
+                higher &= ~(uint64_t)0 << (u % 64);
+            }
+            while (higher != 0) {
+                int v = w * 64 + CTZ64(higher);
+                total += popcountAnd(row, rows + (size_t)v * words, words);
+                higher &= higher - 1;
+            }
+        }
+    }
+
+    return (long long)(total / 3);
+}
 
 typedef struct Node {
     int vertex;
     struct Node* next;
 } Node;
 
+// Wzy przydzielane s z blokw (slabw) nalecych do grafu. Zwolnione wzy trafiaj
+// na list wolnych i s uywane ponownie, a caa pami zwalniana jest razem z grafem.
+#define NODE_SLAB_MIN_CAPACITY 64
+
+typedef struct NodeSlab {
+    struct NodeSlab* next;
+    int capacity;
+    int used;
+    Node nodes[1];
+} NodeSlab;
+
+typedef struct {
+    NodeSlab* slabs;     // ostatnio przydzielony blok jest na pocztku listy
+    Node* free_list;
+} NodePool;
+
+// Indeks ssiadw wierzchoka o duym stopniu: tablica z adresowaniem otwartym (sondowanie
+// liniowe) wskazujca wzy listy ssiedztwa, kluczem jest pole vertex wza. Mae listy
+// indeksu nie maj; powstaje on przy pierwszym wyszukiwaniu, gdy stopie osignie
+// NEIGHBOR_INDEX_THRESHOLD, i jest zwalniany, gdy stopie spadnie poniej poowy progu.
+#define NEIGHBOR_INDEX_THRESHOLD 32
+
+typedef struct {
+    int mask;            // rozmiar tablicy slots (potga dwjki) minus 1
+    int shift;           // 32 - log2(rozmiar), do haszowania mnoeniem
+    int count;
+    Node* slots[1];      // NULL oznacza wolne miejsce
+} NeighborIndex;
+
 typedef struct
 {
     PyObject_HEAD
-    Node* adj_list[16];
+    NodePool pool;
+    Node** adj_list;     // adj_list[v] == NULL <=> wierzchoek v nie istnieje
+    int capacity;        // rozmiar tablicy adj_list, ronie geometrycznie
+    int* degree;         // stopnie wierzchokw (bez wartownika), rozmiar capacity
+    NeighborIndex** neighbor_index;  // indeksy list ssiedztwa (NULL dla maych list), rozmiar capacity
+    int num_vertices;    // liczniki aktualizowane przez wszystkie operacje modyfikujce graf
+    long long num_edges;
+    unsigned long long version;  // zmieniany przy kadej modyfikacji, uniewania iteratory
+    uint64_t hash;       // skrt Zobrista: XOR kluczy wierzchokw i krawdzi (vertexKey, edgeKey)
+    int* parent;         // las zbiorw rozcznych dla connected_components (NULL, gdy nieaktualny)
+    unsigned char* rank;
+    int components;      // liczba skadowych spjnoci, gdy las jest aktualny
 } AdjacencyList;
 
 
-Node* createNode(int v) {
-    Node* newNode = (Node*)malloc(sizeof(Node));
-    if (newNode == NULL) {
-        PyErr_NoMemory();
-        return NULL;
+#define G6_BAD_ORDER 1
+#define G6_TOO_SHORT 2
+#define G6_BAD_CHARACTER 3
+
+// Odczytuje liczb wierzchokw z nagwka formatw g6/sparse6/digraph6 (1, 4 albo 8 znakw).
+// Zwraca dugo nagwka, a w *order liczb wierzchokw albo -1, gdy nagwek jest bdny.
+static int g6ReadOrder(const char* text, Py_ssize_t length, long long* order) {
+    long long n = 0;
+    int header = 1;
+
+    if (length >= 1 && text[0] != '~') {
+        n = text[0] - 63;
     }
-    newNode->vertex = v;
-    newNode->next = NULL;
-    return newNode;
+    else if (length >= 4 && text[1] != '~') {
+        header = 4;
+    }
+    else if (length >= 8) {
+        header = 8;
+    }
+    else {
+        n = -1;
+    }
+
+    for (int i = header == 4 ? 1 : 2; header > 1 && i < header; i++) {
+        if (text[i] < 63 || text[i] > 126) {
+            n = -1;
+            break;
+        }
+        n = (n << 6) | (text[i] - 63);
+    }
+
+    *order = n;
+    return header;
 }
 
-void addEdge(AdjacencyList* self, int src, int dest) {
-    Node* newNode = createNode(dest);
-    newNode->next = self->adj_list[src];
-    self->adj_list[src] = newNode;
+// Odczytuje nagwek formatu g6 i sprawdza dugo reszty tekstu.
+// Zwraca wskanik na pierwszy znak macierzy ssiedztwa albo NULL z kodem bdu w *error.
+// Nie korzysta z API Pythona, wic mona jej uywa bez GIL.
+static const char* g6ParseHeader(const char* text, Py_ssize_t length, int* num_vertices, int* error) {
+    long long n;
+    int header = g6ReadOrder(text, length, &n);
 
-    newNode = createNode(src);
-    newNode->next = self->adj_list[dest];
-    self->adj_list[dest] = newNode;
+    if (n <= 0 || n > INT_MAX) {
+        *error = G6_BAD_ORDER;
+        return NULL;
+    }
+
+    long long bits = n * (n - 1) / 2;
+    if (length - header < (bits + 5) / 6) {
+        *error = G6_TOO_SHORT;
+        return NULL;
+    }
+
+    *num_vertices = (int)n;
+    return text + header;
 }
 
-static void AdjacencyList_dealloc(AdjacencyList* self) {
-    for (int i = 0; i < 16; i++) {
-        Node* current = self->adj_list[i];
-        while (current != NULL) {
-            Node* next = current->next;
-            free(current);
-            current = next;
+// Jak g6ParseHeader, ale w razie bdu ustawia wyjtek ValueError.
+static const char* g6Header(const char* text, Py_ssize_t length, int* num_vertices) {
+    int error = 0;
+    const char* body = g6ParseHeader(text, length, num_vertices, &error);
+
+    if (body == NULL) {
+        if (error == G6_BAD_ORDER) {
+            PyErr_SetString(PyExc_ValueError, "Niepoprawny format g6. Liczba wierzchokw powinna by > 0");
+        }
+        else {
+            PyErr_SetString(PyExc_ValueError, "Niepoprawny format g6. Tekst jest za krtki");
         }
     }
-    Py_TYPE(self)->tp_free((PyObject*)self);
+    return body;
 }
 
-static PyObject* AdjacencyList_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
-    AdjacencyList* self;
-    self = (AdjacencyList*)type->tp_alloc(type, 0);
-    if (self != NULL) {
-        for (int i = 0; i < 16; i++) {
-            self->adj_list[i] = NULL;
-        }
+// Dugo nagwka z liczb wierzchokw n.
+static int g6OrderLength(int n) {
+    return n <= 62 ? 1 : (n <= 258047 ? 4 : 8);
+}
+
+// Zapisuje nagwek z liczb wierzchokw n i zwraca jego dugo.
+static int g6WriteOrder(char* out, int n) {
+    int header = g6OrderLength(n);
+
+    if (header == 1) {
+        out[0] = (char)(n + 63);
+        return 1;
     }
-    return (PyObject*)self;
+
+    out[0] = out[1] = '~';
+    for (int i = header - 1, shift = 0; i >= (header == 4 ? 1 : 2); i--, shift += 6) {
+        out[i] = (char)(((n >> shift) & 0x3F) + 63);
+    }
+    return header;
+}
+
+// Dugo zapisu g6 grafu o n wierzchokach: nagwek plus n(n-1)/2 bitw po 6 na znak.
+static Py_ssize_t g6Length(int n) {
+    return g6OrderLength(n) + (Py_ssize_t)(((long long)n * (n - 1) / 2 + 5) / 6);
 }
 
+// Zapisuje nagwek g6 i zeruje ciao; zwraca wskanik na ciao. Bity krawdzi s
+// ustawiane przez g6SetEdge, a g6Finish zamienia 6-bitowe wartoci na znaki.
+static char* g6Begin(char* out, int n) {
+    int header = g6WriteOrder(out, n);
 
-static int AdjacencyList_init(AdjacencyList* self, PyObject* args, PyObject* kwds) {
-    static char* kwlist[] = { "text", NULL };
-    char* text = "?";
+    memset(out + header, 0, (size_t)(g6Length(n) - header));
+    return out + header;
+}
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", kwlist, &text)) {
-        return -1;
+// Zaznacza krawd u < v w ciele g6 (bity s numerowane kolumnami macierzy ssiedztwa).
+static void g6SetEdge(char* body, int u, int v) {
+    long long bit = (long long)v * (v - 1) / 2 + u;
+    body[bit / 6] |= (char)(32 >> (bit % 6));
+}
+
+static void g6Finish(char* body, int n) {
+    long long length = ((long long)n * (n - 1) / 2 + 5) / 6;
+    for (long long i = 0; i < length; i++) {
+        body[i] += 63;
     }
+}
 
-    if (text[0] != '?') {
-        int num_vertices = text[0] - 63; 
+// Format sparse6 (":" + liczba wierzchokw + strumie krawdzi) zajmuje O(m log n) bitw
+// zamiast n(n-1)/2, wic nadaje si do duych grafw rzadkich. Kada krawd to bit b
+// i numer x zapisany na bits bitach: b = 1 zwiksza biecy wierzchoek v, x > v ustawia
+// v = x, a x <= v oznacza krawd {x, v}. Wierzchoek v nigdy nie maleje.
+typedef struct {
+    const char* position;
+    const char* end;
+    int n;
+    int bits;         // liczba bitw numeru wierzchoka
+    int x;            // biecy znak (6 bitw)
+    int k;            // liczba nieprzeczytanych bitw w x
+    long long v;
+} Sparse6Reader;
 
-        if (num_vertices <= 0) {
-            PyErr_SetString(PyExc_ValueError, "Niepoprawny format g6. Liczba wierzchokw powinna by > 0");
-            return -1;
-        }
+static int sparse6Bits(int n) {
+    int bits = 0;
+    for (long long i = (long long)n - 1; i > 0; i >>= 1) {
+        bits++;
+    }
+    return bits;
+}
 
-        for (int i = 0; i < num_vertices; i++) {
-            Node* newNode = createNode(i);
-            if (newNode == NULL) {
-                PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia wierzchoka");
-                return -1;
+// Odczytuje nagwek sparse6 (tekst zaczyna si od ':'). Zwraca 0 albo kod bdu G6_*.
+// Nie korzysta z API Pythona, wic mona jej uywa bez GIL.
+static int sparse6Open(Sparse6Reader* reader, const char* text, Py_ssize_t length) {
+    long long n;
+    int header = g6ReadOrder(text + 1, length - 1, &n);
+
+    if (n < 0 || n > INT_MAX) {
+        return G6_BAD_ORDER;
+    }
+
+    reader->position = text + 1 + header;
+    reader->end = text + length;
+    reader->n = (int)n;
+    reader->bits = sparse6Bits((int)n);
+    reader->x = 0;
+    reader->k = 0;
+    reader->v = 0;
+    return 0;
+}
+
+// Jak sparse6Open, ale w razie bdu ustawia wyjtek ValueError.
+static int sparse6Header(Sparse6Reader* reader, const char* text, Py_ssize_t length) {
+    if (sparse6Open(reader, text, length) != 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawny format sparse6. Bdna liczba wierzchokw");
+        return -1;
+    }
+    return 0;
+}
+
+// Zwraca 1 i kolejn krawd (*u <= *v), 0 na kocu tekstu albo -G6_BAD_CHARACTER.
+// Krawdzie mog si powtarza i by ptlami; odfiltrowuje je wywoujcy.
+static int sparse6Next(Sparse6Reader* reader, int* u, int* v) {
+    while (1) {
+        if (reader->k == 0) {
+            if (reader->position == reader->end) {
+                return 0;
             }
-            self->adj_list[i] = newNode;
+            reader->x = *reader->position++ - 63;
+            if (reader->x < 0 || reader->x > 63) {
+                return -G6_BAD_CHARACTER;
+            }
+            reader->k = 6;
+        }
+        reader->k--;
+        if ((reader->x & (1 << reader->k)) != 0) {
+            reader->v++;
         }
 
-        int c = 0;
-        int i = 1;
-        int k = 0;
-
-        for (int v = 1; v < num_vertices; v++) {
-            for (int u = 0; u < v; u++) {
-                if (k == 0) {
-                    c = text[i++] - 63;
-                    k = 6;
+        long long x = 0;
+        for (int need = reader->bits; need > 0;) {
+            if (reader->k == 0) {
+                if (reader->position == reader->end) {
+                    return 0;
                 }
-                k--;
-
-                if ((c & (1 << k)) != 0) {
-                    addEdge(self, u, v);
+                reader->x = *reader->position++ - 63;
+                if (reader->x < 0 || reader->x > 63) {
+                    return -G6_BAD_CHARACTER;
                 }
+                reader->k = 6;
             }
+            int take = need < reader->k ? need : reader->k;
+            reader->k -= take;
+            x = (x << take) | ((reader->x >> reader->k) & ((1 << take) - 1));
+            need -= take;
+        }
+
+        if (x > reader->v) {
+            reader->v = x;
+        }
+        else if (reader->v < reader->n) {
+            *u = (int)x;
+            *v = (int)reader->v;
+            return 1;
         }
     }
+}
 
-    return 0;
+static void sparse6CharacterError(void) {
+    PyErr_SetString(PyExc_ValueError, "Niepoprawny format sparse6. Niedozwolony znak");
 }
 
+typedef struct {
+    char* out;        // nastpny znak do zapisania
+    int x;            // bity biecego znaku
+    int k;            // liczba wolnych bitw w x
+    int bits;
+    int n;
+    int last;         // biecy wierzchoek v dekodera
+} Sparse6Writer;
 
-static PyObject *number_of_vertices(AdjacencyList *self) {
-    int counter = 0;
+// Grne ograniczenie dugoci zapisu sparse6 grafu o n wierzchokach i edges krawdziach
+// (kada krawd to co najwyej dwa bity b i dwa numery wierzchokw).
+static Py_ssize_t sparse6Bound(int n, long long edges) {
+    long long bits = edges * (2 + 2 * (long long)sparse6Bits(n));
+    return 1 + g6OrderLength(n) + (Py_ssize_t)((bits + 5) / 6);
+}
 
-    for (int i = 0; i < 16; i++) {
-        if (self->adj_list[i] != NULL) {
-            counter++;
+static void sparse6Put(Sparse6Writer* writer, long long value, int count) {
+    for (int i = count - 1; i >= 0; i--) {
+        writer->x = (writer->x << 1) | (int)((value >> i) & 1);
+        if (--writer->k == 0) {
+            *writer->out++ = (char)(writer->x + 63);
+            writer->x = 0;
+            writer->k = 6;
         }
     }
+}
 
-    return PyLong_FromLong(counter);
+static void sparse6Begin(Sparse6Writer* writer, char* out, int n) {
+    out[0] = ':';
+    writer->out = out + 1 + g6WriteOrder(out + 1, n);
+    writer->x = 0;
+    writer->k = 6;
+    writer->bits = sparse6Bits(n);
+    writer->n = n;
+    writer->last = 0;
 }
 
-static PyObject* vertices(AdjacencyList* self) {
-    PyObject* vertex_set = PySet_New(NULL);
+// Zapisuje krawd u < v. Krawdzie musz by uporzdkowane rosnco wedug v.
+static void sparse6Edge(Sparse6Writer* writer, int u, int v) {
+    if (v == writer->last) {
+        sparse6Put(writer, 0, 1);
+    }
+    else {
+        sparse6Put(writer, 1, 1);
+        if (v > writer->last + 1) {
+            sparse6Put(writer, v, writer->bits);
+            sparse6Put(writer, 0, 1);
+        }
+        writer->last = v;
+    }
+    sparse6Put(writer, u, writer->bits);
+}
 
-    if (vertex_set == NULL)
-    {
-        PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia zbioru dla wierzchokw");
+// Dopenia ostatni znak jedynkami i zwraca dugo caego zapisu. Gdy jedynki dayby si
+// odczyta jako krawd {n - 1, n - 1}, dopenienie zaczyna si od zera (jak w nauty).
+static Py_ssize_t sparse6End(Sparse6Writer* writer, char* out) {
+    if (writer->k != 6) {
+        if (writer->k > writer->bits && writer->last == writer->n - 2 && writer->n == ((long long)1 << writer->bits)) {
+            sparse6Put(writer, 0, 1);
+        }
+        sparse6Put(writer, ((long long)1 << writer->k) - 1, writer->k);
+    }
+    return writer->out - out;
+}
+
+// Odczytuje nagwek formatu digraph6 ('&' + liczba wierzchokw + macierz n x n wierszami).
+// Zwraca wskanik na pierwszy znak macierzy albo NULL z wyjtkiem ValueError.
+static const char* digraph6Header(const char* text, Py_ssize_t length, int* num_vertices) {
+    long long n;
+    int header = g6ReadOrder(text + 1, length - 1, &n);
+
+    if (n < 0 || n > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawny format digraph6. Bdna liczba wierzchokw");
+        return NULL;
+    }
+    if (length - 1 - header < (n * n + 5) / 6) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawny format digraph6. Tekst jest za krtki");
         return NULL;
     }
 
-    for (int i = 0; i < 16; i++)
-    {
-        if (self->adj_list[i] != NULL) {
-            PyObject* vertex = PyLong_FromLong(i);
+    *num_vertices = (int)n;
+    return text + 1 + header;
+}
 
-            if (vertex == NULL)
-            {
-                Py_DECREF(vertex_set);
-                PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia wierzchoka");
-                return NULL;
+// Struktury nieskierowane nie przyjmuj grafw skierowanych.
+static int rejectDigraph6(const char* text, Py_ssize_t length) {
+    if (length > 0 && text[0] == '&') {
+        PyErr_SetString(PyExc_ValueError, "Format digraph6 opisuje graf skierowany, obsuguje go tylko CSRGraph");
+        return -1;
+    }
+    return 0;
+}
+
+// Graf o wierzchokach 0..n-1 zapisany jako wiersze bitowe po words sw, razem z buforem
+// roboczym dla przeszukiwania. Struktura nie korzysta z API Pythona i suy do oblicze
+// wykonywanych bez GIL; bufory s uywane ponownie dla kolejnych grafw.
+typedef struct {
+    int n;
+    int words;
+    uint64_t* rows;
+    uint64_t* scratch;    // 5 * words sw: visited, frontier, next, color0, color1
+    size_t allocated;     // liczba przydzielonych sw (rows + scratch)
+} BitGraph;
+
+static void bitGraphFree(BitGraph* g) {
+    free(g->rows);
+    g->rows = NULL;
+    g->scratch = NULL;
+    g->allocated = 0;
+}
+
+// Najwiksza liczba wierzchokw grafu wczytywanego do BitGraph (wiersze zajmuj wtedy 32 MB
+// na wtek). Rozmiar macierzy wynika z samego nagwka linii, a kilkubajtowa linia sparse6
+// moe zapowiada setki tysicy wierzchokw, wic wiksze grafy s odrzucane.
+#define BITGRAPH_MAX_VERTICES 16384
+
+// Przygotowuje pusty graf o n wierzchokach. Zwraca -2, gdy brakuje pamici, albo -3, gdy
+// n przekracza BITGRAPH_MAX_VERTICES.
+static int bitGraphReset(BitGraph* g, int n) {
+    if (n > BITGRAPH_MAX_VERTICES) {
+        return -3;
+    }
+
+    int words = (n + 63) / 64;
+    size_t needed = (size_t)n * words + 5 * (size_t)words + 1;
+
+    if (needed > g->allocated) {
+        uint64_t* rows = (uint64_t*)malloc(needed * sizeof(uint64_t));
+        if (rows == NULL) {
+            return -2;
+        }
+        free(g->rows);
+        g->rows = rows;
+        g->allocated = needed;
+    }
+
+    g->n = n;
+    g->words = words;
+    g->scratch = g->rows + (size_t)n * words;
+    memset(g->rows, 0, (size_t)n * words * sizeof(uint64_t));
+    return 0;
+}
+
+// Wczytuje graf z linii sparse6 (tekst zaczyna si od ':'); ptle i powtrzone krawdzie
+// s pomijane. Kody bdw jak w bitGraphLoadG6.
+static int bitGraphLoadSparse6(BitGraph* g, const char* text, Py_ssize_t length) {
+    Sparse6Reader reader;
+    int u, v, result;
+
+    if (sparse6Open(&reader, text, length) != 0) {
+        return -1;
+    }
+    if ((result = bitGraphReset(g, reader.n)) < 0) {
+        return result;
+    }
+
+    while ((result = sparse6Next(&reader, &u, &v)) > 0) {
+        if (u != v) {
+            g->rows[(size_t)u * g->words + v / 64] |= (uint64_t)1 << (v % 64);
+            g->rows[(size_t)v * g->words + u / 64] |= (uint64_t)1 << (u % 64);
+        }
+    }
+    return result < 0 ? -1 : 0;
+}
+
+// Wczytuje graf z jednej linii g6 albo sparse6 (zaczynajcej si od ':'). Zwraca -1 dla
+// niepoprawnego tekstu, -2 przy braku pamici i -3 dla grafu wikszego ni BITGRAPH_MAX_VERTICES.
+static int bitGraphLoadG6(BitGraph* g, const char* text, Py_ssize_t length) {
+    int num_vertices = 0;
+    int error = 0;
+    const char* body = NULL;
+
+    if (length > 0 && text[0] == ':') {
+        return bitGraphLoadSparse6(g, text, length);
+    }
+    if (length > 0 && text[0] != '?') {
+        body = g6ParseHeader(text, length, &num_vertices, &error);
+        if (body == NULL) {
+            return -1;
+        }
+    }
+    if ((error = bitGraphReset(g, num_vertices)) < 0) {
+        return error;
+    }
+
+    int words = g->words;
+    int c = 0;
+    long long i = 0;
+    int k = 0;
+
+    for (int v = 1; v < num_vertices; v++) {
+        for (int u = 0; u < v; u++) {
+            if (k == 0) {
+                c = body[i++] - 63;
+                k = 6;
+            }
+            k--;
+
+            if ((c & (1 << k)) != 0) {
+                g->rows[(size_t)u * words + v / 64] |= (uint64_t)1 << (v % 64);
+                g->rows[(size_t)v * words + u / 64] |= (uint64_t)1 << (u % 64);
             }
-            PySet_Add(vertex_set, vertex);
-            Py_DECREF(vertex);
         }
     }
 
-    return vertex_set;
+    return 0;
 }
 
-static PyObject* vertex_degree(AdjacencyList* self, PyObject* args) {
-    int vertex;
+static long long bitGraphEdges(BitGraph* g) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < (size_t)g->n * g->words; i++) {
+        total += (uint64_t)POPCOUNT64(g->rows[i]);
+    }
+    return (long long)(total / 2);
+}
 
-    if (!PyArg_ParseTuple(args, "i", &vertex)) {
-        return NULL;
+// Przeszukiwanie wszerz caymi warstwami: ssiedzi warstwy to suma (OR) wierszy jej
+// wierzchokw. Kady wierzchoek jest rozwijany raz, wic koszt to O(n * words).
+// Zwraca liczb skadowych spjnoci, a w *bipartite informacj o dwudzielnoci
+// (warstwy kolorujemy na przemian; krawd w obrbie koloru oznacza cykl nieparzysty).
+static int bitGraphComponents(BitGraph* g, int* bipartite) {
+    int words = g->words;
+    uint64_t* visited = g->scratch;
+    uint64_t* frontier = visited + words;
+    uint64_t* next = frontier + words;
+    uint64_t* colors[2] = { next + words, next + 2 * words };
+    int components = 0;
+
+    memset(g->scratch, 0, 5 * (size_t)words * sizeof(uint64_t));
+
+    for (int s = 0; s < g->n; s++) {
+        if (visited[s / 64] & ((uint64_t)1 << (s % 64))) {
+            continue;
+        }
+        components++;
+
+        memset(frontier, 0, (size_t)words * sizeof(uint64_t));
+        frontier[s / 64] = (uint64_t)1 << (s % 64);
+        visited[s / 64] |= frontier[s / 64];
+        int color = 0;
+
+        while (1) {
+            memset(next, 0, (size_t)words * sizeof(uint64_t));
+            for (int w = 0; w < words; w++) {
+                uint64_t layer = frontier[w];
+                colors[color][w] |= layer;
+                while (layer != 0) {
+                    const uint64_t* row = g->rows + (size_t)(w * 64 + CTZ64(layer)) * words;
+                    for (int x = 0; x < words; x++) {
+                        next[x] |= row[x];
+                    }
+                    layer &= layer - 1;
+                }
+            }
+
+            uint64_t any = 0;
+            for (int w = 0; w < words; w++) {
+                next[w] &= ~visited[w];
+                visited[w] |= next[w];
+                frontier[w] = next[w];
+                any |= next[w];
+            }
+            if (any == 0) {
+                break;
+            }
+            color = 1 - color;
+        }
     }
 
-    if (vertex < 0 || vertex >= 16) {
-        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
-        return NULL;
+    if (bipartite != NULL) {
+        *bipartite = 1;
+        for (int v = 0; v < g->n && *bipartite; v++) {
+            int color = (colors[1][v / 64] >> (v % 64)) & 1;
+            if (popcountAnd(g->rows + (size_t)v * words, colors[color], words) != 0) {
+                *bipartite = 0;
+            }
+        }
     }
 
+    return components;
+}
 
-    Node* current = self->adj_list[vertex];
-    int degree = 0;
+// Silnik przeszukiwania wszerz na tablicach CSR grafu nieskierowanego, wsplny dla analiz
+// opartych na BFS. Warstwy s rozwijane "z gry" (od wierzchokw warstwy do ssiadw),
+// a gdy krawdzi wychodzcych z warstwy jest duo - "z dou": nieodwiedzone wierzchoki
+// szukaj ssiada w warstwie i kocz po pierwszym trafieniu (Beamer i in.). Dla grafw
+// o maej rednicy pomija to wikszo krawdzi. Przy n <= 64 warstwy s maskami bitowymi.
+#define BFS_ALPHA 14
+#define BFS_BETA 24
 
-    while (current != NULL && current->next != NULL) {
-        degree++;
-        current = current->next;
+typedef struct {
+    int n;
+    const int64_t* offsets;
+    const int32_t* targets;
+    int* distance;        // odlego od rda przeszukiwania, -1: nieodwiedzony
+    int32_t* queue;       // wierzchoki w kolejnoci odwiedzenia
+    int count;            // liczba odwiedzonych od ostatniego bfsClear
+    uint64_t* frontier;   // maska biecej warstwy przy przejciu z dou
+    uint64_t* rows;       // wiersze ssiedztwa dla n <= 64, w przeciwnym razie NULL
+} Bfs;
+
+static void bfsFree(Bfs* bfs) {
+    free(bfs->distance);
+    free(bfs->queue);
+    free(bfs->frontier);
+    free(bfs->rows);
+}
+
+// Przygotowuje przeszukiwanie grafu (tablice nie s kopiowane). Zwraca -1, gdy brakuje pamici.
+static int bfsInit(Bfs* bfs, int n, const int64_t* offsets, const int32_t* targets) {
+    bfs->n = n;
+    bfs->offsets = offsets;
+    bfs->targets = targets;
+    bfs->count = 0;
+    bfs->distance = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    bfs->queue = (int32_t*)malloc(((size_t)n + 1) * sizeof(int32_t));
+    bfs->frontier = (uint64_t*)calloc((size_t)n / 64 + 1, sizeof(uint64_t));
+    bfs->rows = n <= 64 ? (uint64_t*)calloc(64, sizeof(uint64_t)) : NULL;
+    if (bfs->distance == NULL || bfs->queue == NULL || bfs->frontier == NULL || (n <= 64 && bfs->rows == NULL)) {
+        bfsFree(bfs);
+        return -1;
     }
 
-    return PyLong_FromLong(degree);
+    for (int v = 0; v < n; v++) {
+        bfs->distance[v] = -1;
+    }
+    for (int v = 0; bfs->rows != NULL && v < n; v++) {
+        for (int64_t i = offsets[v]; i < offsets[v + 1]; i++) {
+            bfs->rows[v] |= (uint64_t)1 << targets[i];
+        }
+    }
+    return 0;
 }
 
+// Oznacza wszystkie wierzchoki jako nieodwiedzone w czasie proporcjonalnym do liczby odwiedzonych.
+static void bfsClear(Bfs* bfs) {
+    for (int i = 0; i < bfs->count; i++) {
+        bfs->distance[bfs->queue[i]] = -1;
+    }
+    bfs->count = 0;
+}
 
+// Przeszukuje skadow wierzchoka source (nieodwiedzonego). Odwiedzone wierzchoki s
+// dopisywane do queue (od pozycji count sprzed wywoania) razem z odlegociami.
+// Zwraca liczb nowo odwiedzonych wierzchokw.
+static int bfsRun(Bfs* bfs, int source) {
+    int n = bfs->n;
+    int* distance = bfs->distance;
+    int32_t* queue = bfs->queue;
+    int start = bfs->count;
+    int count = start;
 
-static PyObject* vertex_neighbors(AdjacencyList* self, PyObject* args) {
-    int vertex;
+    distance[source] = 0;
+    queue[count++] = source;
 
-    if (!PyArg_ParseTuple(args, "i", &vertex)) {
-        return NULL;
+    if (bfs->rows != NULL) {
+        uint64_t seen = 0;
+        for (int v = 0; v < n; v++) {
+            if (distance[v] >= 0) {
+                seen |= (uint64_t)1 << v;
+            }
+        }
+        uint64_t layer = (uint64_t)1 << source;
+        for (int level = 1; layer != 0; level++) {
+            uint64_t next = 0;
+            for (; layer != 0; layer &= layer - 1) {
+                next |= bfs->rows[CTZ64(layer)];
+            }
+            next &= ~seen;
+            seen |= next;
+            layer = next;
+            for (; next != 0; next &= next - 1) {
+                int v = CTZ64(next);
+                distance[v] = level;
+                queue[count++] = v;
+            }
+        }
+        bfs->count = count;
+        return count - start;
     }
 
-    if (vertex < 0 || vertex >= 16) {
-        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
-        return NULL;
+    const int64_t* offsets = bfs->offsets;
+    const int32_t* targets = bfs->targets;
+    int64_t unexplored = offsets[n];
+    int bottomUp = 0;
+    int layerStart = start;
+
+    for (int level = 1; layerStart < count; level++) {
+        int layerEnd = count;
+        int64_t frontierArcs = 0;
+        for (int i = layerStart; i < layerEnd; i++) {
+            frontierArcs += offsets[queue[i] + 1] - offsets[queue[i]];
+        }
+
+        if (!bottomUp && frontierArcs > unexplored / BFS_ALPHA) {
+            bottomUp = 1;
+        }
+        else if (bottomUp && layerEnd - layerStart < n / BFS_BETA) {
+            bottomUp = 0;
+        }
+
+        if (bottomUp) {
+            for (int i = layerStart; i < layerEnd; i++) {
+                bfs->frontier[queue[i] / 64] |= (uint64_t)1 << (queue[i] % 64);
+            }
+            for (int v = 0; v < n; v++) {
+                if (distance[v] != -1) {
+                    continue;
+                }
+                for (int64_t i = offsets[v]; i < offsets[v + 1]; i++) {
+                    int u = targets[i];
+                    if (bfs->frontier[u / 64] & ((uint64_t)1 << (u % 64))) {
+                        distance[v] = level;
+                        queue[count++] = v;
+                        break;
+                    }
+                }
+            }
+            for (int i = layerStart; i < layerEnd; i++) {
+                bfs->frontier[queue[i] / 64] = 0;
+            }
+        }
+        else {
+            unexplored -= frontierArcs;
+            for (int i = layerStart; i < layerEnd; i++) {
+                int u = queue[i];
+                for (int64_t j = offsets[u]; j < offsets[u + 1]; j++) {
+                    int w = targets[j];
+                    if (distance[w] == -1) {
+                        distance[w] = level;
+                        queue[count++] = w;
+                    }
+                }
+            }
+        }
+        layerStart = layerEnd;
     }
 
-    PyObject* neighbors_set = PySet_New(NULL);
+    bfs->count = count;
+    return count - start;
+}
 
-    if (neighbors_set == NULL) {
-        PyErr_SetString(PyExc_RuntimeError, "Nie udao si utworzy zbioru ssiadw");
-        return NULL;
+// Liczy skadowe spjnoci grafu CSR; w *bipartite (o ile podano) zapisuje, czy graf jest
+// dwudzielny, czyli czy adna krawd nie czy wierzchokw o tej samej odlegoci od
+// rda swojej skadowej. Zwraca -1, gdy brakuje pamici.
+static int csrArraysComponents(int n, const int64_t* offsets, const int32_t* targets, int* bipartite) {
+    Bfs bfs;
+    if (bfsInit(&bfs, n, offsets, targets) < 0) {
+        return -1;
+    }
+
+    int components = 0;
+    for (int s = 0; s < n; s++) {
+        if (bfs.distance[s] == -1) {
+            bfsRun(&bfs, s);
+            components++;
+        }
+    }
+
+    if (bipartite != NULL) {
+        *bipartite = 1;
+        for (int u = 0; u < n && *bipartite; u++) {
+            for (int64_t i = offsets[u]; i < offsets[u + 1]; i++) {
+                if (bfs.distance[targets[i]] == bfs.distance[u]) {
+                    *bipartite = 0;
+                    break;
+                }
+            }
+        }
+    }
+
+    bfsFree(&bfs);
+    return components;
+}
+
+static Py_ssize_t atomicFetchAdd(volatile Py_ssize_t* value, Py_ssize_t delta) {
+#if defined(_MSC_VER)
+    return (Py_ssize_t)InterlockedExchangeAdd64((volatile LONG64*)value, (LONG64)delta);
+#else
+    return __atomic_fetch_add(value, delta, __ATOMIC_RELAXED);
+#endif
+}
+
+static int cpuCount(void) {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// Funkcja robocza wtku razem z jej wsplnymi danymi.
+typedef struct {
+    void (*worker)(void*);
+    void* job;
+} WorkerTask;
+
+#ifdef _WIN32
+static DWORD WINAPI workerThread(LPVOID task) {
+    ((WorkerTask*)task)->worker(((WorkerTask*)task)->job);
+    return 0;
+}
+#else
+static void* workerThread(void* task) {
+    ((WorkerTask*)task)->worker(((WorkerTask*)task)->job);
+    return NULL;
+}
+#endif
+
+// Uruchamia worker(job) w threads wtkach (wtek wywoujcy te pracuje).
+// Jeli nie uda si utworzy ktrego wtku, prac przejmuj pozostae.
+static void runWorkers(void (*worker)(void*), void* job, int threads) {
+#ifdef _WIN32
+    HANDLE* handles = (HANDLE*)malloc((size_t)threads * sizeof(HANDLE));
+#else
+    pthread_t* handles = (pthread_t*)malloc((size_t)threads * sizeof(pthread_t));
+#endif
+    WorkerTask task = { worker, job };
+    int started = 0;
+
+    for (int i = 1; handles != NULL && i < threads; i++) {
+#ifdef _WIN32
+        handles[started] = CreateThread(NULL, 0, workerThread, &task, 0, NULL);
+        if (handles[started] == NULL) {
+            break;
+        }
+#else
+        if (pthread_create(&handles[started], NULL, workerThread, &task) != 0) {
+            break;
+        }
+#endif
+        started++;
+    }
+
+    worker(job);
+
+    for (int i = 0; i < started; i++) {
+#ifdef _WIN32
+        WaitForSingleObject(handles[i], INFINITE);
+        CloseHandle(handles[i]);
+#else
+        pthread_join(handles[i], NULL);
+#endif
+    }
+    free(handles);
+}
+
+// Odlegoci midzy wszystkimi parami wierzchokw grafu CSR. Grafy o co najwyej 64
+// wierzchokach przeszukujemy ze wszystkich rde jednoczenie: bit s w reach[v] mwi,
+// e v zosta ju osignity z s, wic jedna warstwa to OR masek ssiadw. Wiksze grafy
+// s przeszukiwane silnikiem BFS osobno z kadego rda, rwnolegle w wielu wtkach.
+
+// Wtki pobieraj rda przeszukiwa porcjami o tym rozmiarze ze wsplnego licznika.
+#define DISTANCE_CHUNK 16
+
+typedef struct {
+    int n;
+    const int64_t* offsets;
+    const int32_t* targets;
+    int32_t* matrix;          // n * n odlegoci (-1: brak cieki) albo NULL
+    int32_t* eccentricity;    // -1: nie wszystkie wierzchoki osigalne, -2: brak pamici
+    int64_t* sums;            // suma odlegoci od rda do osigalnych wierzchokw
+    volatile Py_ssize_t next; // pierwsze rdo, ktrego nikt jeszcze nie pobra
+} DistanceJob;
+
+static void distancesBitParallel(DistanceJob* job) {
+    int n = job->n;
+    uint64_t rows[64];
+    uint64_t reach[64];
+    uint64_t next[64];
+
+    for (int v = 0; v < n; v++) {
+        rows[v] = 0;
+        for (int64_t i = job->offsets[v]; i < job->offsets[v + 1]; i++) {
+            rows[v] |= (uint64_t)1 << job->targets[i];
+        }
+        reach[v] = (uint64_t)1 << v;
+        job->eccentricity[v] = 0;
+        job->sums[v] = 0;
+    }
+    if (job->matrix != NULL) {
+        memset(job->matrix, 0xff, (size_t)n * n * sizeof(int32_t));
+        for (int v = 0; v < n; v++) {
+            job->matrix[(size_t)v * n + v] = 0;
+        }
+    }
+
+    for (int level = 1;; level++) {
+        int changed = 0;
+        for (int v = 0; v < n; v++) {
+            next[v] = reach[v];
+            for (uint64_t bits = rows[v]; bits != 0; bits &= bits - 1) {
+                next[v] |= reach[CTZ64(bits)];
+            }
+        }
+        for (int v = 0; v < n; v++) {
+            for (uint64_t fresh = next[v] & ~reach[v]; fresh != 0; fresh &= fresh - 1) {
+                int s = CTZ64(fresh);
+                job->eccentricity[s] = level;
+                job->sums[s] += level;
+                if (job->matrix != NULL) {
+                    job->matrix[(size_t)s * n + v] = level;
+                }
+                changed = 1;
+            }
+            reach[v] = next[v];
+        }
+        if (!changed) {
+            break;
+        }
+    }
+
+    // rda, z ktrych osignito wszystkie wierzchoki
+    uint64_t complete = n > 0 ? ~(uint64_t)0 : 0;
+    for (int v = 0; v < n; v++) {
+        complete &= reach[v];
+    }
+    for (int s = 0; s < n; s++) {
+        if (!(complete & ((uint64_t)1 << s))) {
+            job->eccentricity[s] = -1;
+        }
+    }
+}
+
+static void distanceWorker(void* argument) {
+    DistanceJob* job = (DistanceJob*)argument;
+    int n = job->n;
+    Bfs bfs;
+    int ready = bfsInit(&bfs, n, job->offsets, job->targets) == 0;
+
+    while (1) {
+        Py_ssize_t first = atomicFetchAdd(&job->next, DISTANCE_CHUNK);
+        if (first >= n) {
+            break;
+        }
+        int last = first + DISTANCE_CHUNK < n ? (int)first + DISTANCE_CHUNK : n;
+
+        for (int s = (int)first; s < last; s++) {
+            if (!ready) {
+                job->eccentricity[s] = -2;
+                continue;
+            }
+
+            bfsRun(&bfs, s);
+            int32_t* row = job->matrix != NULL ? job->matrix + (size_t)s * n : NULL;
+            if (row != NULL && bfs.count < n) {
+                memset(row, 0xff, (size_t)n * sizeof(int32_t));
+            }
+            int64_t sum = 0;
+            for (int i = 0; i < bfs.count; i++) {
+                int v = bfs.queue[i];
+                sum += bfs.distance[v];
+                if (row != NULL) {
+                    row[v] = bfs.distance[v];
+                }
+            }
+            // Wierzchoki s w kolejce w kolejnoci niemalejcych odlegoci
+            job->eccentricity[s] = bfs.count == n ? bfs.distance[bfs.queue[bfs.count - 1]] : -1;
+            job->sums[s] = sum;
+            bfsClear(&bfs);
+        }
+    }
+
+    if (ready) {
+        bfsFree(&bfs);
+    }
+}
+
+// Wypenia eccentricity i sums (oraz matrix, o ile podano) dla grafu CSR o n wierzchokach.
+// Zwraca -1, gdy brakuje pamici.
+static int allDistances(int n, const int64_t* offsets, const int32_t* targets,
+                        int32_t* matrix, int32_t* eccentricity, int64_t* sums, int threads) {
+    DistanceJob job;
+    job.n = n;
+    job.offsets = offsets;
+    job.targets = targets;
+    job.matrix = matrix;
+    job.eccentricity = eccentricity;
+    job.sums = sums;
+    job.next = 0;
+
+    if (n <= 64) {
+        distancesBitParallel(&job);
+        return 0;
+    }
+
+    if (threads > n / DISTANCE_CHUNK + 1) {
+        threads = n / DISTANCE_CHUNK + 1;
+    }
+    runWorkers(distanceWorker, &job, threads);
+
+    for (int s = 0; s < n; s++) {
+        if (eccentricity[s] == -2) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+// Generator liczb pseudolosowych xoshiro256** (Blackman, Vigna); stan inicjujemy
+// cigiem splitmix64, wic kade ziarno (take 0) daje poprawny stan.
+typedef struct {
+    uint64_t s[4];
+} Random;
+
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t x = (*state += 0x9E3779B97F4A7C15ULL);
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static void randomSeed(Random* rng, uint64_t seed) {
+    for (int i = 0; i < 4; i++) {
+        rng->s[i] = splitmix64(&seed);
+    }
+}
+
+static uint64_t rotl64(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+
+static uint64_t randomNext(Random* rng) {
+    uint64_t* s = rng->s;
+    uint64_t result = rotl64(s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl64(s[3], 45);
+    return result;
+}
+
+// Liczba z przedziau [0, 1) o 53 losowych bitach.
+static double randomDouble(Random* rng) {
+    return (double)(randomNext(rng) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+// Liczba z przedziau [0, bound) bez obcienia: odrzucamy pocztkowe 2^64 mod bound wartoci.
+static uint64_t randomBelow(Random* rng, uint64_t bound) {
+    uint64_t threshold = (0 - bound) % bound;
+    uint64_t x;
+    do {
+        x = randomNext(rng);
+    } while (x < threshold);
+    return x % bound;
+}
+
+// Zbir krawdzi {u, v} z adresowaniem otwartym; klucz pusty to ~0.
+typedef struct {
+    uint64_t* keys;
+    uint64_t mask;
+} EdgeSet;
+
+static int edgeSetInit(EdgeSet* set, long long count) {
+    uint64_t capacity = 16;
+    while (capacity < 2 * (uint64_t)count) {
+        capacity *= 2;
+    }
+    set->mask = capacity - 1;
+    set->keys = (uint64_t*)malloc(capacity * sizeof(uint64_t));
+    if (set->keys == NULL) {
+        return -1;
+    }
+    memset(set->keys, 0xff, capacity * sizeof(uint64_t));
+    return 0;
+}
+
+static uint64_t* edgeSetSlot(EdgeSet* set, int u, int v) {
+    uint64_t key = u < v ? (uint64_t)u << 32 | (uint32_t)v : (uint64_t)v << 32 | (uint32_t)u;
+    uint64_t state = key;
+    uint64_t i = splitmix64(&state) & set->mask;
+    while (set->keys[i] != ~(uint64_t)0 && set->keys[i] != key) {
+        i = (i + 1) & set->mask;
+    }
+    return &set->keys[i];
+}
+
+static int edgeSetContains(EdgeSet* set, int u, int v) {
+    return *edgeSetSlot(set, u, v) != ~(uint64_t)0;
+}
+
+// Dodaje krawd (zbir musi mie miejsce); zwraca 0, gdy ju w nim bya.
+static int edgeSetAdd(EdgeSet* set, int u, int v) {
+    uint64_t* slot = edgeSetSlot(set, u, v);
+    if (*slot != ~(uint64_t)0) {
+        return 0;
+    }
+    *slot = u < v ? (uint64_t)u << 32 | (uint32_t)v : (uint64_t)v << 32 | (uint32_t)u;
+    return 1;
+}
+
+// Para {u, v}, u < v, o numerze index w porzdku (0, 1), (0, 2), (1, 2), (0, 3), ...
+static void pairFromIndex(long long index, int* u, int* v) {
+    long long w = (long long)((1.0 + sqrt(1.0 + 8.0 * (double)index)) / 2.0);
+    while (w * (w - 1) / 2 > index) {
+        w--;
+    }
+    while ((w + 1) * w / 2 <= index) {
+        w++;
+    }
+    *u = (int)(index - w * (w - 1) / 2);
+    *v = (int)w;
+}
+
+// Dopisuje krawd do tablicy par, podwajajc j w razie potrzeby. Zwraca -1, gdy brakuje pamici.
+static int appendPair(int** pairs, long long* count, long long* capacity, int u, int v) {
+    if (*count == *capacity) {
+        int* grown = (int*)realloc(*pairs, (size_t)*capacity * 4 * sizeof(int));
+        if (grown == NULL) {
+            return -1;
+        }
+        *pairs = grown;
+        *capacity *= 2;
+    }
+    (*pairs)[2 * *count] = u;
+    (*pairs)[2 * *count + 1] = v;
+    (*count)++;
+    return 0;
+}
+
+// Graf losowy G(n, p): kolejne krawdzie wybieramy, przeskakujc geometrycznie rozoon
+// liczb par (Batagelj, Brandes), wic koszt jest proporcjonalny do n + m, a nie do n^2.
+// Zapisuje krawdzie do *pairs (malloc) i zwraca ich liczb albo -1, gdy brakuje pamici.
+static long long gnpPairs(Random* rng, int n, double p, int** pairs) {
+    double total = (double)n * (n - 1) / 2;
+    long long capacity = (long long)(p * total * 1.1) + 16;
+    long long count = 0;
+
+    *pairs = (int*)malloc((size_t)capacity * 2 * sizeof(int));
+    if (*pairs == NULL) {
+        return -1;
+    }
+    if (p <= 0.0) {
+        return 0;
+    }
+
+    double logq = log1p(-p);
+    long long w = -1;
+    for (int v = 1; v < n;) {
+        if (p >= 1.0) {
+            w++;
+        }
+        else {
+            double skip = floor(log1p(-randomDouble(rng)) / logq);
+            if (skip >= total) {
+                break;
+            }
+            w += 1 + (long long)skip;
+        }
+        while (w >= v && v < n) {
+            w -= v;
+            v++;
+        }
+        if (v < n && appendPair(pairs, &count, &capacity, (int)w, v) < 0) {
+            free(*pairs);
+            *pairs = NULL;
+            return -1;
+        }
+    }
+    return count;
+}
+
+// Graf losowy G(n, m). Rzadkie grafy losujemy, odrzucajc powtrzone pary; gdy m przekracza
+// poow wszystkich par, losujemy w ten sam sposb pary pominite (jest ich mniej ni m).
+// Zwraca m albo -1, gdy brakuje pamici.
+static long long gnmPairs(Random* rng, int n, long long m, int** pairs) {
+    long long total = (long long)n * (n - 1) / 2;
+    int complement = m > total / 2;
+    long long drawn = complement ? total - m : m;
+    EdgeSet set;
+
+    *pairs = (int*)malloc(((size_t)m + 1) * 2 * sizeof(int));
+    if (*pairs == NULL || edgeSetInit(&set, drawn) < 0) {
+        free(*pairs);
+        *pairs = NULL;
+        return -1;
+    }
+
+    long long count = 0;
+    while (count < drawn) {
+        int u, v;
+        pairFromIndex((long long)randomBelow(rng, (uint64_t)total), &u, &v);
+        if (edgeSetAdd(&set, u, v)) {
+            if (!complement) {
+                (*pairs)[2 * count] = u;
+                (*pairs)[2 * count + 1] = v;
+            }
+            count++;
+        }
+    }
+
+    if (complement) {
+        count = 0;
+        for (int v = 1; v < n; v++) {
+            for (int u = 0; u < v; u++) {
+                if (!edgeSetContains(&set, u, v)) {
+                    (*pairs)[2 * count] = u;
+                    (*pairs)[2 * count + 1] = v;
+                    count++;
+                }
+            }
+        }
+    }
+
+    free(set.keys);
+    return m;
+}
+
+// Czy wrd kocw pozostaych do poczenia s dwa rne, jeszcze niessiednie wierzchoki.
+static int regularPairingPossible(EdgeSet* set, const int* stubs, long long count) {
+    for (long long i = 0; i < count; i++) {
+        for (long long j = i + 1; j < count; j++) {
+            if (stubs[i] != stubs[j] && !edgeSetContains(set, stubs[i], stubs[j])) {
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+// Losowy graf d-regularny przez losowe parowanie z restartami: koce krawdzi (d na wierzchoek)
+// tasujemy i czymy kolejno w pary, odrzucajc ptle i krawdzie wielokrotne; odrzucone koce
+// tasujemy i czymy ponownie, a gdy regularPairingPossible (O(k^2) dla k pozostaych kocw)
+// nie znajduje ju adnej dopuszczalnej pary, zaczynamy od nowa. Dla d > (n - 1) / 2
+// losujemy dopenienie grafu (n - 1 - d)-regularnego. Wymaga 0 <= d < n i parzystego n * d.
+// Zwraca liczb krawdzi albo -1, gdy brakuje pamici.
+static long long regularPairs(Random* rng, int n, int d, int** pairs) {
+    int complement = d > (n - 1) / 2;
+    int degree = complement ? n - 1 - d : d;
+    long long drawn = (long long)n * degree / 2;
+    long long edges = (long long)n * d / 2;
+    EdgeSet set;
+
+    *pairs = (int*)malloc(((size_t)(edges > drawn ? edges : drawn) + 1) * 2 * sizeof(int));
+    int* stubs = (int*)malloc(((size_t)2 * drawn + 1) * sizeof(int));
+    if (*pairs == NULL || stubs == NULL || edgeSetInit(&set, drawn) < 0) {
+        free(*pairs);
+        free(stubs);
+        *pairs = NULL;
+        return -1;
+    }
+
+    long long count = 0;
+    long long remaining = 0;
+    while (count < drawn) {
+        if (remaining == 0) {
+            // Nowa prba: puste krawdzie i wszystkie koce do poczenia
+            memset(set.keys, 0xff, (set.mask + 1) * sizeof(uint64_t));
+            count = 0;
+            for (int v = 0; v < n; v++) {
+                for (int k = 0; k < degree; k++) {
+                    stubs[remaining++] = v;
+                }
+            }
+        }
+
+        for (long long i = remaining - 1; i > 0; i--) {
+            long long j = (long long)randomBelow(rng, (uint64_t)i + 1);
+            int t = stubs[i];
+            stubs[i] = stubs[j];
+            stubs[j] = t;
+        }
+
+        long long left = 0;
+        for (long long i = 0; i < remaining; i += 2) {
+            int u = stubs[i];
+            int v = stubs[i + 1];
+            if (u != v && edgeSetAdd(&set, u, v)) {
+                (*pairs)[2 * count] = u;
+                (*pairs)[2 * count + 1] = v;
+                count++;
+            }
+            else {
+                stubs[left++] = u;
+                stubs[left++] = v;
+            }
+        }
+        remaining = left;
+        if (remaining > 0 && !regularPairingPossible(&set, stubs, remaining)) {
+            remaining = 0;
+        }
+    }
+
+    if (complement) {
+        count = 0;
+        for (int v = 1; v < n; v++) {
+            for (int u = 0; u < v; u++) {
+                if (!edgeSetContains(&set, u, v)) {
+                    (*pairs)[2 * count] = u;
+                    (*pairs)[2 * count + 1] = v;
+                    count++;
+                }
+            }
+        }
+    }
+
+    free(stubs);
+    free(set.keys);
+    return count;
+}
+
+// Posta kanoniczna grafu o co najwyej 64 wierzchokach metod indywidualizacji
+// i ucilania podziau (jak w nauty, w uproszczonej wersji). Podzia wierzchokw to
+// cig komrek zapisany jako permutacja lab i maska starts (bit i: na pozycji i zaczyna
+// si komrka). Licie drzewa przeszukiwania to podziay dyskretne; za posta kanoniczn
+// bierzemy najwikszy (leksykograficznie) graf przenumerowany wedug licia. Dwa licie
+// dajce ten sam graf wyznaczaj automorfizm, ktry pozwala pomija rwnowane poddrzewa.
+#define CANONICAL_MAX_VERTICES 64
+#define CANONICAL_MAX_GENERATORS 64
+
+typedef struct {
+    int n;
+    const uint64_t* rows;
+    int haveLeaf;
+    unsigned char path[CANONICAL_MAX_VERTICES];       // wierzchoki indywidualizowane na biecej ciece
+    int firstDepth;                                   // pierwszy li i jego cieka
+    unsigned char firstPath[CANONICAL_MAX_VERTICES];
+    unsigned char firstLab[CANONICAL_MAX_VERTICES];
+    uint64_t firstCert[CANONICAL_MAX_VERTICES];
+    int bestDepth;                                    // najlepszy dotd li
+    unsigned char bestPath[CANONICAL_MAX_VERTICES];
+    unsigned char bestLab[CANONICAL_MAX_VERTICES];
+    uint64_t bestCert[CANONICAL_MAX_VERTICES];
+    int generators;                                   // znalezione automorfizmy
+    unsigned char generator[CANONICAL_MAX_GENERATORS][CANONICAL_MAX_VERTICES];
+} CanonicalSearch;
+
+// Zwraca pozycj za kocem komrki zaczynajcej si na pozycji i.
+static int cellEnd(uint64_t starts, int i, int n) {
+    uint64_t later = starts & ~(((uint64_t)2 << i) - 1);
+    return later != 0 ? CTZ64(later) : n;
+}
+
+// Dzieli komrk [x, y) wedug liczby ssiadw w zbiorze splitter; podkomrki s
+// uporzdkowane rosnco wedug tej liczby. Zwraca 1, jeli komrka zostaa podzielona.
+static int splitCell(const uint64_t* rows, unsigned char* lab, uint64_t* starts, int x, int y, uint64_t splitter) {
+    int count[CANONICAL_MAX_VERTICES];
+    int uniform = 1;
+
+    for (int i = x; i < y; i++) {
+        count[i] = POPCOUNT64(rows[lab[i]] & splitter);
+        uniform &= count[i] == count[x];
+    }
+    if (uniform) {
+        return 0;
+    }
+
+    for (int i = x + 1; i < y; i++) {
+        int c = count[i];
+        unsigned char v = lab[i];
+        int j = i;
+        for (; j > x && count[j - 1] > c; j--) {
+            count[j] = count[j - 1];
+            lab[j] = lab[j - 1];
+        }
+        count[j] = c;
+        lab[j] = v;
+    }
+    for (int i = x + 1; i < y; i++) {
+        if (count[i] != count[i - 1]) {
+            *starts |= (uint64_t)1 << i;
+        }
+    }
+    return 1;
+}
+
+// Ucila podzia, a stanie si rwnomierny: wierzchoki kadej komrki maj tyle samo
+// ssiadw w kadej komrce. Wynik zaley tylko od struktury grafu i podziau, a nie od
+// numeracji wierzchokw.
+static void canonicalRefine(const uint64_t* rows, int n, unsigned char* lab, uint64_t* starts) {
+    int changed = 1;
+
+    while (changed) {
+        changed = 0;
+        for (int s = 0; s < n; s = cellEnd(*starts, s, n)) {
+            uint64_t splitter = 0;
+            for (int i = s, e = cellEnd(*starts, s, n); i < e; i++) {
+                splitter |= (uint64_t)1 << lab[i];
+            }
+            for (int x = 0; x < n;) {
+                int y = cellEnd(*starts, x, n);
+                if (y - x > 1 && splitCell(rows, lab, starts, x, y, splitter)) {
+                    changed = 1;
+                }
+                x = y;
+            }
+        }
+    }
+}
+
+// Wiersze grafu przenumerowanego wedug podziau dyskretnego: wierzchoek lab[i] dostaje numer i.
+static void canonicalCertificate(const CanonicalSearch* cs, const unsigned char* lab, uint64_t* cert) {
+    unsigned char position[CANONICAL_MAX_VERTICES];
+
+    for (int i = 0; i < cs->n; i++) {
+        position[lab[i]] = (unsigned char)i;
+    }
+    for (int i = 0; i < cs->n; i++) {
+        uint64_t row = 0;
+        for (uint64_t neighbors = cs->rows[lab[i]]; neighbors != 0; neighbors &= neighbors - 1) {
+            row |= (uint64_t)1 << position[CTZ64(neighbors)];
+        }
+        cert[i] = row;
+    }
+}
+
+static int compareCertificates(const uint64_t* a, const uint64_t* b, int n) {
+    for (int i = 0; i < n; i++) {
+        if (a[i] != b[i]) {
+            return a[i] < b[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+// Zapamituje automorfizm fromLab[i] -> lab[i]. Jeli przeprowadza on ciek tamtego
+// licia na biec, to poddrzewo, w ktrym cieki si rozeszy, jest obrazem ju
+// przejrzanego i przeszukiwanie wraca do miejsca rozejcia (zwracany poziom).
+static int canonicalAutomorphism(CanonicalSearch* cs, const unsigned char* fromLab, const unsigned char* fromPath,
+    int fromDepth, const unsigned char* lab, int level) {
+    unsigned char gamma[CANONICAL_MAX_VERTICES];
+
+    for (int i = 0; i < cs->n; i++) {
+        gamma[fromLab[i]] = lab[i];
+    }
+    if (cs->generators < CANONICAL_MAX_GENERATORS) {
+        memcpy(cs->generator[cs->generators++], gamma, (size_t)cs->n);
+    }
+
+    if (fromDepth != level) {
+        return level - 1;
+    }
+    for (int i = 0; i < level; i++) {
+        if (gamma[fromPath[i]] != cs->path[i]) {
+            return level - 1;
+        }
+    }
+    int diverge = 0;
+    while (diverge < level && fromPath[diverge] == cs->path[diverge]) {
+        diverge++;
+    }
+    return diverge;
+}
+
+static int canonicalLeaf(CanonicalSearch* cs, const unsigned char* lab, int level) {
+    uint64_t cert[CANONICAL_MAX_VERTICES];
+    int n = cs->n;
+
+    canonicalCertificate(cs, lab, cert);
+    if (!cs->haveLeaf) {
+        cs->haveLeaf = 1;
+        cs->firstDepth = cs->bestDepth = level;
+        memcpy(cs->firstPath, cs->path, (size_t)level);
+        memcpy(cs->bestPath, cs->path, (size_t)level);
+        memcpy(cs->firstLab, lab, (size_t)n);
+        memcpy(cs->bestLab, lab, (size_t)n);
+        memcpy(cs->firstCert, cert, (size_t)n * sizeof(uint64_t));
+        memcpy(cs->bestCert, cert, (size_t)n * sizeof(uint64_t));
+        return level - 1;
+    }
+
+    if (compareCertificates(cert, cs->firstCert, n) == 0) {
+        return canonicalAutomorphism(cs, cs->firstLab, cs->firstPath, cs->firstDepth, lab, level);
+    }
+    int order = compareCertificates(cert, cs->bestCert, n);
+    if (order == 0) {
+        return canonicalAutomorphism(cs, cs->bestLab, cs->bestPath, cs->bestDepth, lab, level);
+    }
+    if (order > 0) {
+        cs->bestDepth = level;
+        memcpy(cs->bestPath, cs->path, (size_t)level);
+        memcpy(cs->bestLab, lab, (size_t)n);
+        memcpy(cs->bestCert, cert, (size_t)n * sizeof(uint64_t));
+    }
+    return level - 1;
+}
+
+static int orbitFind(unsigned char* parent, int v) {
+    while (parent[v] != v) {
+        parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+// Sprawdza, czy v ley w tej samej orbicie co ktry z ju sprawdzonych wierzchokw
+// wzgldem automorfizmw ustalajcych wszystkie wierzchoki cieki do poziomu level.
+static int sameOrbit(const CanonicalSearch* cs, int level, int v, const unsigned char* tried, int triedCount) {
+    unsigned char parent[CANONICAL_MAX_VERTICES];
+
+    for (int i = 0; i < cs->n; i++) {
+        parent[i] = (unsigned char)i;
+    }
+    for (int k = 0; k < cs->generators; k++) {
+        const unsigned char* gamma = cs->generator[k];
+        int fixes = 1;
+        for (int i = 0; i < level && fixes; i++) {
+            fixes = gamma[cs->path[i]] == cs->path[i];
+        }
+        for (int x = 0; fixes && x < cs->n; x++) {
+            parent[orbitFind(parent, x)] = (unsigned char)orbitFind(parent, gamma[x]);
+        }
+    }
+
+    int root = orbitFind(parent, v);
+    for (int i = 0; i < triedCount; i++) {
+        if (orbitFind(parent, tried[i]) == root) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Przeszukuje poddrzewo wza na poziomie level (podzia lab/starts przed ucileniem).
+// Zwraca poziom, na ktrym przeszukiwanie ma by kontynuowane: level - 1 normalnie,
+// mniej po znalezieniu automorfizmu pozwalajcego pomin reszt poddrzewa.
+static int canonicalSearch(CanonicalSearch* cs, unsigned char* lab, uint64_t starts, int level) {
+    int n = cs->n;
+
+    canonicalRefine(cs->rows, n, lab, &starts);
+
+    int target = -1;
+    int targetEnd = n;
+    for (int s = 0; s < n; s = targetEnd) {
+        targetEnd = cellEnd(starts, s, n);
+        if (targetEnd - s > 1) {
+            target = s;
+            break;
+        }
+    }
+    if (target < 0) {
+        return canonicalLeaf(cs, lab, level);
+    }
+
+    unsigned char cell[CANONICAL_MAX_VERTICES];
+    unsigned char tried[CANONICAL_MAX_VERTICES];
+    int size = targetEnd - target;
+    int triedCount = 0;
+    memcpy(cell, lab + target, (size_t)size);
+
+    for (int k = 0; k < size; k++) {
+        int v = cell[k];
+        // Na pierwszej ciece pomijamy wierzchoki z orbit ju sprawdzonych dzieci
+        if (triedCount > 0 && memcmp(cs->path, cs->firstPath, (size_t)level) == 0 &&
+            sameOrbit(cs, level, v, tried, triedCount)) {
+            continue;
+        }
+
+        unsigned char child[CANONICAL_MAX_VERTICES];
+        memcpy(child, lab, (size_t)n);
+        for (int i = target; i < targetEnd; i++) {
+            if (child[i] == v) {
+                child[i] = child[target];
+                child[target] = (unsigned char)v;
+                break;
+            }
+        }
+
+        cs->path[level] = (unsigned char)v;
+        tried[triedCount++] = (unsigned char)v;
+        int back = canonicalSearch(cs, child, starts | ((uint64_t)1 << (target + 1)), level + 1);
+        if (back < level) {
+            return back;
+        }
+    }
+    return level - 1;
+}
+
+// Zapisuje do out (g6Length(n) znakw) posta kanoniczn grafu g w formacie g6: grafy
+// izomorficzne daj identyczny tekst. Zwraca 64-bitowy skrt (FNV-1a) tego tekstu,
+// nieujemny, albo -3, gdy graf ma wicej ni CANONICAL_MAX_VERTICES wierzchokw.
+static int64_t canonicalG6(BitGraph* g, char* out) {
+    int n = g->n;
+    if (n > CANONICAL_MAX_VERTICES) {
+        return -3;
+    }
+
+    CanonicalSearch search;
+    CanonicalSearch* cs = &search;
+    unsigned char lab[CANONICAL_MAX_VERTICES];
+    cs->n = n;
+    cs->rows = g->rows;
+    cs->haveLeaf = 0;
+    cs->generators = 0;
+    for (int i = 0; i < n; i++) {
+        lab[i] = (unsigned char)i;
+    }
+    if (n > 0) {
+        canonicalSearch(cs, lab, 1, 0);
+    }
+
+    char* body = g6Begin(out, n);
+    for (int v = 1; v < n; v++) {
+        for (uint64_t lower = cs->bestCert[v] & (((uint64_t)1 << v) - 1); lower != 0; lower &= lower - 1) {
+            g6SetEdge(body, CTZ64(lower), v);
+        }
+    }
+    g6Finish(body, n);
+
+    uint64_t hash = 14695981039346656037ULL;
+    for (Py_ssize_t i = 0; i < g6Length(n); i++) {
+        hash = (hash ^ (unsigned char)out[i]) * 1099511628211ULL;
+    }
+    return (int64_t)(hash & (uint64_t)INT64_MAX);
+}
+
+// Zwraca posta kanoniczn grafu zapisanego w tekcie g6 (metody canonical_g6 wszystkich
+// struktur korzystaj z ich to_g6). Przejmuje referencj do text.
+static PyObject* canonicalText(PyObject* text) {
+    if (text == NULL) {
+        return NULL;
+    }
+
+    BitGraph g = { 0, 0, NULL, NULL, 0 };
+    PyObject* result = NULL;
+    int loaded = bitGraphLoadG6(&g, (const char*)PyUnicode_1BYTE_DATA(text), PyUnicode_GET_LENGTH(text));
+    Py_DECREF(text);
+
+    // Kody bdw jak w map_corpus; -3 (graf za duy na BitGraph) przekracza te limit postaci kanonicznej
+    if (loaded == -2) {
+        PyErr_NoMemory();
+    }
+    else if (loaded == -1) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawny format g6");
+    }
+    else if (loaded == -3 || g.n > CANONICAL_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Posta kanoniczna jest dostpna dla grafw o co najwyej 64 wierzchokach");
+    }
+    else if ((result = PyUnicode_New(g6Length(g.n), 127)) != NULL) {
+        canonicalG6(&g, (char*)PyUnicode_1BYTE_DATA(result));
+    }
+
+    bitGraphFree(&g);
+    return result;
+}
+
+
+// Przydziela nowy blok na co najmniej count wzw.
+static int nodePoolReserve(NodePool* pool, int count) {
+    if (pool->slabs != NULL && pool->slabs->capacity - pool->slabs->used >= count) {
+        return 0;
+    }
+
+    int capacity = NODE_SLAB_MIN_CAPACITY;
+    if (pool->slabs != NULL && capacity < 2 * pool->slabs->capacity) {
+        capacity = 2 * pool->slabs->capacity;
+    }
+    if (capacity < count) {
+        capacity = count;
+    }
+
+    NodeSlab* slab = (NodeSlab*)malloc(sizeof(NodeSlab) + (size_t)(capacity - 1) * sizeof(Node));
+    if (slab == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    slab->capacity = capacity;
+    slab->used = 0;
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+    return 0;
+}
+
+static void nodePoolClear(NodePool* pool) {
+    NodeSlab* slab = pool->slabs;
+    while (slab != NULL) {
+        NodeSlab* next = slab->next;
+        free(slab);
+        slab = next;
+    }
+    pool->slabs = NULL;
+    pool->free_list = NULL;
+}
+
+Node* createNode(NodePool* pool, int v) {
+    Node* newNode = pool->free_list;
+
+    if (newNode != NULL) {
+        pool->free_list = newNode->next;
+    }
+    else {
+        if (pool->slabs == NULL || pool->slabs->used == pool->slabs->capacity) {
+            if (nodePoolReserve(pool, 1) < 0) {
+                return NULL;
+            }
+        }
+        newNode = &pool->slabs->nodes[pool->slabs->used++];
+    }
+
+    newNode->vertex = v;
+    newNode->next = NULL;
+    return newNode;
+}
+
+void freeNode(NodePool* pool, Node* node) {
+    node->next = pool->free_list;
+    pool->free_list = node;
+}
+
+// Las zbiorw rozcznych (union-find) z kompresj cieek i czeniem wedug rangi.
+// Dodawanie wierzchokw i krawdzi aktualizuje go na bieco, wic connected_components
+// kosztuje O(1); usunicie krawdzi albo wierzchoka moe rozspjni skadow, dlatego
+// uniewania las, a nastpne zapytanie buduje go od nowa.
+static void forestInvalidate(AdjacencyList* self) {
+    free(self->parent);
+    free(self->rank);
+    self->parent = NULL;
+    self->rank = NULL;
+}
+
+static int forestFind(int* parent, int v) {
+    int root = v;
+    while (parent[root] != root) {
+        root = parent[root];
+    }
+    while (parent[v] != root) {
+        int next = parent[v];
+        parent[v] = root;
+        v = next;
+    }
+    return root;
+}
+
+static void forestUnion(AdjacencyList* self, int u, int v) {
+    u = forestFind(self->parent, u);
+    v = forestFind(self->parent, v);
+    if (u == v) {
+        return;
+    }
+
+    if (self->rank[u] < self->rank[v]) {
+        self->parent[u] = v;
+    }
+    else {
+        self->parent[v] = u;
+        if (self->rank[u] == self->rank[v]) {
+            self->rank[u]++;
+        }
+    }
+    self->components--;
+}
+
+// Rozszerza las do rozmiaru tablicy wierzchokw; nowe pozycje s osobnymi zbiorami.
+// Gdy brakuje pamici, las jest po prostu uniewaniany.
+static void forestGrow(AdjacencyList* self, int oldCapacity) {
+    int* parent = (int*)realloc(self->parent, (size_t)self->capacity * sizeof(int));
+    if (parent == NULL) {
+        forestInvalidate(self);
+        return;
+    }
+    self->parent = parent;
+
+    unsigned char* rank = (unsigned char*)realloc(self->rank, (size_t)self->capacity);
+    if (rank == NULL) {
+        forestInvalidate(self);
+        return;
+    }
+    self->rank = rank;
+
+    for (int v = oldCapacity; v < self->capacity; v++) {
+        parent[v] = v;
+        rank[v] = 0;
+    }
+}
+
+static size_t neighborIndexHome(const NeighborIndex* index, int vertex) {
+    return (size_t)(((uint32_t)vertex * 0x9E3779B1u) >> index->shift);
+}
+
+// Tworzy pusty indeks mieszczcy count wzw przy wypenieniu najwyej 1/2.
+static NeighborIndex* neighborIndexAlloc(int count) {
+    int bits = 6;
+    while (bits < 30 && (1 << bits) < 2 * (long long)count) {
+        bits++;
+    }
+
+    NeighborIndex* index = (NeighborIndex*)calloc(1, sizeof(NeighborIndex) + (((size_t)1 << bits) - 1) * sizeof(Node*));
+    if (index != NULL) {
+        index->mask = (1 << bits) - 1;
+        index->shift = 32 - bits;
+    }
+    return index;
+}
+
+// Zwraca miejsce z wzem o kluczu vertex albo wolne miejsce, w ktrym powinien si znale.
+static Node** neighborIndexProbe(NeighborIndex* index, int vertex) {
+    size_t i = neighborIndexHome(index, vertex);
+    while (index->slots[i] != NULL && index->slots[i]->vertex != vertex) {
+        i = (i + 1) & (size_t)index->mask;
+    }
+    return &index->slots[i];
+}
+
+// Wstawia wze (albo podmienia wze o tym samym kluczu), w razie potrzeby powikszajc
+// tablic. Zwraca -1, gdy brakuje pamici.
+static int neighborIndexPut(NeighborIndex** index, Node* node) {
+    if (2 * ((long long)(*index)->count + 1) > (long long)(*index)->mask + 1) {
+        NeighborIndex* grown = neighborIndexAlloc(2 * ((*index)->count + 1));
+        if (grown == NULL) {
+            return -1;
+        }
+        for (int i = 0; i <= (*index)->mask; i++) {
+            if ((*index)->slots[i] != NULL) {
+                *neighborIndexProbe(grown, (*index)->slots[i]->vertex) = (*index)->slots[i];
+            }
+        }
+        grown->count = (*index)->count;
+        free(*index);
+        *index = grown;
+    }
+
+    Node** slot = neighborIndexProbe(*index, node->vertex);
+    if (*slot == NULL) {
+        (*index)->count++;
+    }
+    *slot = node;
+    return 0;
+}
+
+// Usuwa klucz vertex, przesuwajc wstecz dalsze elementy cigu sondowania (bez nagrobkw).
+static void neighborIndexRemove(NeighborIndex* index, int vertex) {
+    size_t mask = (size_t)index->mask;
+    Node** slots = index->slots;
+    size_t hole = (size_t)(neighborIndexProbe(index, vertex) - slots);
+    if (slots[hole] == NULL) {
+        return;
+    }
+    slots[hole] = NULL;
+    index->count--;
+
+    for (size_t j = (hole + 1) & mask; slots[j] != NULL; j = (j + 1) & mask) {
+        size_t home = neighborIndexHome(index, slots[j]->vertex);
+        // Element z j moe wypeni dziur, jeli jego pozycja domowa nie ley
+        // cyklicznie w przedziale (hole, j]
+        if (((j - home) & mask) >= ((j - hole) & mask)) {
+            slots[hole] = slots[j];
+            slots[j] = NULL;
+            hole = j;
+        }
+    }
+}
+
+static void dropNeighborIndex(AdjacencyList* self, int vertex) {
+    free(self->neighbor_index[vertex]);
+    self->neighbor_index[vertex] = NULL;
+}
+
+static void clearNeighborIndexes(AdjacencyList* self) {
+    for (int v = 0; v < self->capacity; v++) {
+        dropNeighborIndex(self, v);
+    }
+}
+
+// Dopisuje nowy wze listy wierzchoka do jego indeksu, jeli indeks istnieje.
+// Indeks jest tylko przyspieszeniem, wic gdy brakuje pamici, zostaje zwolniony.
+static void indexNeighbor(AdjacencyList* self, int vertex, Node* node) {
+    if (self->neighbor_index[vertex] != NULL && neighborIndexPut(&self->neighbor_index[vertex], node) < 0) {
+        dropNeighborIndex(self, vertex);
+    }
+}
+
+// Zwraca wze listy ssiedztwa u o kluczu v albo NULL. Dla list o duym stopniu
+// korzysta z indeksu (budujc go przy pierwszym uyciu), dla maych przeglda list.
+static Node* findNeighbor(AdjacencyList* self, int u, int v) {
+    if (u >= self->capacity) {
+        return NULL;
+    }
+
+    NeighborIndex* index = self->neighbor_index[u];
+    if (index == NULL && self->degree[u] >= NEIGHBOR_INDEX_THRESHOLD) {
+        index = neighborIndexAlloc(self->degree[u] + 1);
+        for (Node* current = self->adj_list[u]; index != NULL && current != NULL; current = current->next) {
+            *neighborIndexProbe(index, current->vertex) = current;
+            index->count++;
+        }
+        self->neighbor_index[u] = index;
+    }
+    if (index != NULL) {
+        return *neighborIndexProbe(index, v);
+    }
+
+    for (Node* current = self->adj_list[u]; current != NULL; current = current->next) {
+        if (current->vertex == v) {
+            return current;
+        }
+    }
+    return NULL;
+}
+
+// Zapewnia miejsce w tablicy wierzchokw dla indeksu vertex. Tablica ronie
+// co najmniej dwukrotnie, wic dodawanie kolejnych wierzchokw kosztuje
+// zamortyzowane O(1).
+static int ensureCapacity(AdjacencyList* self, int vertex) {
+    if (vertex < self->capacity) {
+        return 0;
+    }
+
+    long long capacity = 2 * (long long)self->capacity;
+    if (capacity < 16) {
+        capacity = 16;
+    }
+    if (capacity <= vertex) {
+        capacity = (long long)vertex + 1;
+    }
+    if (capacity > INT_MAX) {
+        capacity = INT_MAX;
+    }
+
+    Node** adj_list = (Node**)realloc(self->adj_list, (size_t)capacity * sizeof(Node*));
+    if (adj_list == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(adj_list + self->capacity, 0, (size_t)(capacity - self->capacity) * sizeof(Node*));
+    self->adj_list = adj_list;
+
+    int* degree = (int*)realloc(self->degree, (size_t)capacity * sizeof(int));
+    if (degree == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(degree + self->capacity, 0, (size_t)(capacity - self->capacity) * sizeof(int));
+    self->degree = degree;
+
+    NeighborIndex** neighbor_index = (NeighborIndex**)realloc(self->neighbor_index, (size_t)capacity * sizeof(NeighborIndex*));
+    if (neighbor_index == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    memset(neighbor_index + self->capacity, 0, (size_t)(capacity - self->capacity) * sizeof(NeighborIndex*));
+    self->neighbor_index = neighbor_index;
+
+    int oldCapacity = self->capacity;
+    self->capacity = (int)capacity;
+    if (self->parent != NULL) {
+        forestGrow(self, oldCapacity);
+    }
+    return 0;
+}
+
+// Klucze haszowania Zobrista (mieszanie splitmix64). Skrt grafu to XOR kluczy jego
+// wierzchokw i krawdzi, wic kada modyfikacja aktualizuje go w O(1), a grafy o tych
+// samych wierzchokach i krawdziach maj ten sam skrt niezalenie od historii zmian.
+static uint64_t zobristKey(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static uint64_t vertexKey(int v) {
+    // Drugi koniec 0xFFFFFFFF nie jest numerem wierzchoka, wic klucze nie koliduj z edgeKey
+    return zobristKey((uint64_t)(uint32_t)v << 32 | 0xFFFFFFFFu);
+}
+
+static uint64_t edgeKey(int u, int v) {
+    if (u > v) {
+        int t = u;
+        u = v;
+        v = t;
+    }
+    return zobristKey((uint64_t)(uint32_t)u << 32 | (uint32_t)v);
+}
+
+static int insertVertex(AdjacencyList* self, int vertex);
+
+int addEdge(AdjacencyList* self, int src, int dest) {
+    // Krawd do nieistniejcego wierzchoka tworzy go przez insertVertex, wic kada
+    // lista koczy si wartownikiem
+    if (insertVertex(self, src) < 0 || insertVertex(self, dest) < 0) {
+        return -1;
+    }
+
+    // Oba wzy s przydzielane przed jakkolwiek zmian, wic przy braku pamici krawd
+    // nie jest dodawana, a liczniki i skrt nadal odpowiadaj zawartoci list
+    Node* first = createNode(&self->pool, dest);
+    Node* second = first != NULL ? createNode(&self->pool, src) : NULL;
+    if (second == NULL) {
+        if (first != NULL) {
+            freeNode(&self->pool, first);
+        }
+        return -1;
+    }
+
+    first->next = self->adj_list[src];
+    self->adj_list[src] = first;
+    indexNeighbor(self, src, first);
+    second->next = self->adj_list[dest];
+    self->adj_list[dest] = second;
+    indexNeighbor(self, dest, second);
+
+    if (self->parent != NULL) {
+        forestUnion(self, src, dest);
+    }
+    self->num_edges++;
+    self->version++;
+    self->hash ^= edgeKey(src, dest);
+    self->degree[src]++;
+    self->degree[dest]++;
+    return 0;
+}
+
+// Zwraca list ssiedztwa wierzchoka albo NULL, gdy wierzchoek nie istnieje.
+static Node* adjacency(AdjacencyList* self, int vertex) {
+    return vertex < self->capacity ? self->adj_list[vertex] : NULL;
+}
+
+// Odczytuje liczb cakowit o podanym rozmiarze (1, 2, 4 albo 8 bajtw) z bufora;
+// wartoci bez znaku wiksze od LLONG_MAX zwracane s jako -1 (poza zakresem).
+static long long bufferInteger(const char* item, Py_ssize_t size, int isSigned) {
+    switch (size) {
+    case 1: {
+        int8_t s;
+        uint8_t u;
+        memcpy(&s, item, 1);
+        memcpy(&u, item, 1);
+        return isSigned ? s : u;
+    }
+    case 2: {
+        int16_t s;
+        uint16_t u;
+        memcpy(&s, item, 2);
+        memcpy(&u, item, 2);
+        return isSigned ? s : u;
+    }
+    case 4: {
+        int32_t s;
+        uint32_t u;
+        memcpy(&s, item, 4);
+        memcpy(&u, item, 4);
+        return isSigned ? s : (long long)u;
+    }
+    default: {
+        int64_t s;
+        uint64_t u;
+        memcpy(&s, item, 8);
+        memcpy(&u, item, 8);
+        return isSigned ? s : (u > (uint64_t)LLONG_MAX ? -1 : (long long)u);
+    }
+    }
+}
+
+// Odczytuje pary wierzchokw z bufora liczb cakowitych (ksztat (k, 2) albo paski
+// o parzystej dugoci, np. array('i') lub tablica numpy) albo z dowolnego obiektu
+// iterowalnego zwracajcego pary. Sprawdza od razu, e wszystkie indeksy nale do
+// [0, limit). Zwraca liczb par, a w *pairs tablic kolejnych kocw krawdzi
+// (do zwolnienia przez free), albo -1, gdy dane s niepoprawne.
+static Py_ssize_t readEdgePairs(PyObject* edges, int limit, int** pairs) {
+    *pairs = NULL;
+
+    if (PyObject_CheckBuffer(edges)) {
+        Py_buffer view;
+        if (PyObject_GetBuffer(edges, &view, PyBUF_FORMAT | PyBUF_C_CONTIGUOUS) < 0) {
+            return -1;
+        }
+
+        const char* format = view.format != NULL ? view.format : "B";
+        if (*format == '@' || *format == '=') {
+            format++;
+        }
+        Py_ssize_t size = view.itemsize;
+        if (format[0] == '\0' || format[1] != '\0' || strchr("bBhHiIlLqQnN", format[0]) == NULL ||
+            (size != 1 && size != 2 && size != 4 && size != 8)) {
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_TypeError, "Bufor krawdzi musi zawiera liczby cakowite");
+            return -1;
+        }
+
+        Py_ssize_t items = view.len / size;
+        if (items % 2 != 0 || view.ndim > 2 || (view.ndim == 2 && view.shape[1] != 2)) {
+            PyBuffer_Release(&view);
+            PyErr_SetString(PyExc_ValueError, "Bufor krawdzi musi mie ksztat (k, 2)");
+            return -1;
+        }
+
+        *pairs = (int*)malloc((size_t)items * sizeof(int) + 1);
+        if (*pairs == NULL) {
+            PyBuffer_Release(&view);
+            PyErr_NoMemory();
+            return -1;
+        }
+        int isSigned = format[0] >= 'a';
+        for (Py_ssize_t i = 0; i < items; i++) {
+            long long vertex = bufferInteger((const char*)view.buf + i * size, size, isSigned);
+            if (vertex < 0 || vertex >= limit) {
+                PyBuffer_Release(&view);
+                free(*pairs);
+                *pairs = NULL;
+                PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+                return -1;
+            }
+            (*pairs)[i] = (int)vertex;
+        }
+        PyBuffer_Release(&view);
+        return items / 2;
+    }
+
+    PyObject* iterator = PyObject_GetIter(edges);
+    if (iterator == NULL) {
+        return -1;
+    }
+
+    Py_ssize_t capacity = 64;
+    Py_ssize_t count = 0;
+    *pairs = (int*)malloc(2 * (size_t)capacity * sizeof(int));
+    if (*pairs == NULL) {
+        PyErr_NoMemory();
+    }
+
+    PyObject* item;
+    while (*pairs != NULL && (item = PyIter_Next(iterator)) != NULL) {
+        PyObject* pair = PySequence_Fast(item, "Oczekiwano par wierzchokw (u, v)");
+        Py_DECREF(item);
+        if (pair == NULL) {
+            break;
+        }
+        if (PySequence_Fast_GET_SIZE(pair) != 2) {
+            Py_DECREF(pair);
+            PyErr_SetString(PyExc_ValueError, "Oczekiwano par wierzchokw (u, v)");
+            break;
+        }
+        if (count == capacity) {
+            int* grown = (int*)realloc(*pairs, 4 * (size_t)capacity * sizeof(int));
+            if (grown == NULL) {
+                Py_DECREF(pair);
+                PyErr_NoMemory();
+                break;
+            }
+            *pairs = grown;
+            capacity *= 2;
+        }
+        for (int k = 0; k < 2; k++) {
+            long long vertex = PyLong_AsLongLong(PySequence_Fast_GET_ITEM(pair, k));
+            if (vertex == -1 && PyErr_Occurred()) {
+                break;
+            }
+            if (vertex < 0 || vertex >= limit) {
+                PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+                break;
+            }
+            (*pairs)[2 * count + k] = (int)vertex;
+        }
+        Py_DECREF(pair);
+        if (PyErr_Occurred()) {
+            break;
+        }
+        count++;
+    }
+    Py_DECREF(iterator);
+
+    if (PyErr_Occurred()) {
+        free(*pairs);
+        *pairs = NULL;
+        return -1;
+    }
+    return count;
+}
+
+// Opakowuje bufor bytes w memoryview o podanym formacie elementw, np. 'q' dla int64
+// (numpy.frombuffer moe z niego korzysta bez kopiowania). Przejmuje referencj do bytes.
+static PyObject* bytesView(PyObject* bytes, const char* format) {
+    if (bytes == NULL) {
+        return NULL;
+    }
+    PyObject* view = PyMemoryView_FromObject(bytes);
+    Py_DECREF(bytes);
+    if (view == NULL) {
+        return NULL;
+    }
+    PyObject* result = PyObject_CallMethod(view, "cast", "s", format);
+    Py_DECREF(view);
+    return result;
+}
+
+// Zapytania o odlegoci obsugiwane przez distanceQuery.
+#define DISTANCE_MATRIX 0
+#define DISTANCE_ECCENTRICITIES 1
+#define DISTANCE_DIAMETER 2
+#define DISTANCE_WIENER_INDEX 3
+
+// Odczytuje opcjonalny argument threads (0 lub brak: tyle wtkw, ile procesorw).
+// Zwraca liczb wtkw albo -1 przy bdzie argumentw.
+static int parseThreads(PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "threads", NULL };
+    int threads = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|i", kwlist, &threads)) {
+        return -1;
+    }
+    return threads > 0 ? threads : cpuCount();
+}
+
+// Wsplna cz distance_matrix, eccentricities, diameter i wiener_index dla grafu
+// nieskierowanego w postaci CSR. Macierz odlegoci (-1: brak cieki) i mimorody
+// zwracamy jako memoryview typu int32, wiersz po wierszu w kolejnoci wierzchokw.
+static PyObject* distanceQuery(int n, const int64_t* offsets, const int32_t* targets, int query, int threads) {
+    if (query == DISTANCE_DIAMETER && n == 0) {
+        PyErr_SetString(PyExc_ValueError, "Graf nie ma wierzchokw");
+        return NULL;
+    }
+    if (query == DISTANCE_MATRIX && n > 0 && (size_t)n > (size_t)PY_SSIZE_T_MAX / sizeof(int32_t) / (size_t)n) {
+        return PyErr_NoMemory();
+    }
+
+    PyObject* matrix = NULL;
+    PyObject* eccentricities = NULL;
+    if (query == DISTANCE_MATRIX &&
+        (matrix = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)n * n * (Py_ssize_t)sizeof(int32_t))) == NULL) {
+        return NULL;
+    }
+    if ((eccentricities = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)n * (Py_ssize_t)sizeof(int32_t))) == NULL) {
+        Py_XDECREF(matrix);
+        return NULL;
+    }
+    int64_t* sums = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+    if (sums == NULL) {
+        Py_XDECREF(matrix);
+        Py_DECREF(eccentricities);
+        return PyErr_NoMemory();
+    }
+
+    int32_t* eccentricity = (int32_t*)PyBytes_AS_STRING(eccentricities);
+    int status;
+    Py_BEGIN_ALLOW_THREADS
+    status = allDistances(n, offsets, targets, matrix != NULL ? (int32_t*)PyBytes_AS_STRING(matrix) : NULL,
+                          eccentricity, sums, threads);
+    Py_END_ALLOW_THREADS
+
+    int64_t wiener = 0;
+    int diameter = 0;
+    int connected = 1;
+    for (int v = 0; v < n; v++) {
+        wiener += sums[v];
+        diameter = eccentricity[v] > diameter ? eccentricity[v] : diameter;
+        connected &= eccentricity[v] >= 0;
+    }
+    free(sums);
+
+    if (status < 0) {
+        Py_XDECREF(matrix);
+        Py_DECREF(eccentricities);
+        return PyErr_NoMemory();
+    }
+    if (query == DISTANCE_MATRIX) {
+        Py_DECREF(eccentricities);
+        return bytesView(matrix, "i");
+    }
+    if (!connected) {
+        Py_DECREF(eccentricities);
+        PyErr_SetString(PyExc_ValueError, "Graf nie jest spjny");
+        return NULL;
+    }
+    switch (query) {
+    case DISTANCE_ECCENTRICITIES:
+        return bytesView(eccentricities, "i");
+    case DISTANCE_DIAMETER:
+        Py_DECREF(eccentricities);
+        return PyLong_FromLong(diameter);
+    default:
+        // Kada para zostaa policzona z obu kocw
+        Py_DECREF(eccentricities);
+        return PyLong_FromLongLong(wiener / 2);
+    }
+}
+
+// Modele grafw losowych obsugiwane przez randomGraphPairs.
+#define RANDOM_GNP 0
+#define RANDOM_GNM 1
+#define RANDOM_REGULAR 2
+
+// Inicjuje generator ziarnem seed (liczba cakowita) albo, gdy seed to None, ziarnem
+// zalenym od czasu i licznika wywoa. Zwraca -1 przy bdzie argumentu.
+static int parseSeed(PyObject* seed, Random* rng) {
+    static uint64_t calls = 0;
+
+    if (seed == NULL || seed == Py_None) {
+        uint64_t state = (uint64_t)time(NULL) ^ (uint64_t)clock() << 32 ^ (uint64_t)(uintptr_t)&calls;
+        state ^= splitmix64(&state) + ++calls;
+        randomSeed(rng, splitmix64(&state));
+        return 0;
+    }
+    if (!PyLong_Check(seed)) {
+        PyErr_SetString(PyExc_TypeError, "Ziarno musi by liczb cakowit");
+        return -1;
+    }
+    uint64_t value = PyLong_AsUnsignedLongLongMask(seed);
+    if (value == (uint64_t)-1 && PyErr_Occurred()) {
+        return -1;
+    }
+    randomSeed(rng, value);
+    return 0;
+}
+
+// Wsplna cz create_gnp(n, p), create_gnm(n, m) i create_random_regular(n, d): sprawdza
+// argumenty i losuje krawdzie grafu o wierzchokach 0..n-1 (bez ptli i powtrze) do
+// *pairs. Zwraca ich liczb albo -1 przy bdzie.
+static long long randomGraphPairs(int model, PyObject* args, PyObject* kwds, int maxVertices, int* n, int** pairs) {
+    static char* gnpKwlist[] = { "n", "p", "seed", NULL };
+    static char* gnmKwlist[] = { "n", "m", "seed", NULL };
+    static char* regularKwlist[] = { "n", "d", "seed", NULL };
+    PyObject* seed = NULL;
+    double p = 0.0;
+    long long m = 0;
+    int d = 0;
+    int parsed;
+
+    switch (model) {
+    case RANDOM_GNP:
+        parsed = PyArg_ParseTupleAndKeywords(args, kwds, "id|O", gnpKwlist, n, &p, &seed);
+        break;
+    case RANDOM_GNM:
+        parsed = PyArg_ParseTupleAndKeywords(args, kwds, "iL|O", gnmKwlist, n, &m, &seed);
+        break;
+    default:
+        parsed = PyArg_ParseTupleAndKeywords(args, kwds, "ii|O", regularKwlist, n, &d, &seed);
+        break;
+    }
+    if (!parsed) {
+        return -1;
+    }
+
+    long long total = (long long)*n * (*n - 1) / 2;
+    if (*n < 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return -1;
+    }
+    if (*n > maxVertices) {
+        PyErr_SetString(PyExc_ValueError, "Macierz ssiedztwa obsuguje co najwyej 64 wierzchoki");
+        return -1;
+    }
+    if (model == RANDOM_GNP && !(p >= 0.0 && p <= 1.0)) {
+        PyErr_SetString(PyExc_ValueError, "Prawdopodobiestwo musi nalee do przedziau [0, 1]");
+        return -1;
+    }
+    if (model == RANDOM_GNM && (m < 0 || m > total)) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba krawdzi");
+        return -1;
+    }
+    if (model == RANDOM_REGULAR && (d < 0 || d >= (*n > 0 ? *n : 1) || (long long)*n * d % 2 != 0)) {
+        PyErr_SetString(PyExc_ValueError, "Nie istnieje graf regularny o podanym stopniu i liczbie wierzchokw");
+        return -1;
+    }
+    double expected = model == RANDOM_GNP ? p * (double)total : model == RANDOM_GNM ? (double)m : (double)*n * d / 2;
+    if (expected > INT_MAX / 2) {
+        PyErr_SetString(PyExc_ValueError, "Graf ma zbyt wiele krawdzi");
+        return -1;
+    }
+
+    Random rng;
+    if (parseSeed(seed, &rng) < 0) {
+        return -1;
+    }
+
+    long long count;
+    Py_BEGIN_ALLOW_THREADS
+    switch (model) {
+    case RANDOM_GNP:
+        count = gnpPairs(&rng, *n, p, pairs);
+        break;
+    case RANDOM_GNM:
+        count = gnmPairs(&rng, *n, m, pairs);
+        break;
+    default:
+        count = regularPairs(&rng, *n, d, pairs);
+        break;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (count < 0) {
+        PyErr_NoMemory();
+    }
+    return count;
+}
+
+// Tworzy pusty graf podanego typu (bez parsowania argumentw __init__).
+static PyObject* emptyGraph(PyTypeObject* type) {
+    PyObject* noArgs = PyTuple_New(0);
+    if (noArgs == NULL) {
+        return NULL;
+    }
+    PyObject* graph = type->tp_new(type, noArgs, NULL);
+    Py_DECREF(noArgs);
+    return graph;
+}
+
+// Dodaje wierzchoek, jeli jeszcze nie istnieje.
+static int insertVertex(AdjacencyList* self, int vertex) {
+    if (ensureCapacity(self, vertex) < 0) {
+        return -1;
+    }
+    if (self->adj_list[vertex] == NULL) {
+        Node* newNode = createNode(&self->pool, vertex);
+        if (newNode == NULL) {
+            return -1;
+        }
+        self->adj_list[vertex] = newNode;
+        self->num_vertices++;
+        self->version++;
+        self->hash ^= vertexKey(vertex);
+        self->components++;
+    }
+    return 0;
+}
+
+static int hasEdge(AdjacencyList* self, int u, int v) {
+    // Ptli nie ma w grafie, a findNeighbor(u, u) znalazby wartownika listy u
+    if (u == v) {
+        return 0;
+    }
+    // Listy s symetryczne, wic wystarczy przeszuka krtsz z nich
+    if (v < self->capacity && u < self->capacity && self->degree[v] < self->degree[u]) {
+        int t = u;
+        u = v;
+        v = t;
+    }
+    return findNeighbor(self, u, v) != NULL;
+}
+
+static void AdjacencyList_dealloc(AdjacencyList* self) {
+    forestInvalidate(self);
+    clearNeighborIndexes(self);
+    free(self->neighbor_index);
+    free(self->degree);
+    nodePoolClear(&self->pool);
+    free(self->adj_list);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+static PyObject* AdjacencyList_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    AdjacencyList* self;
+    self = (AdjacencyList*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->pool.slabs = NULL;
+        self->pool.free_list = NULL;
+        self->adj_list = NULL;
+        self->capacity = 0;
+        self->degree = NULL;
+        self->neighbor_index = NULL;
+        self->num_vertices = 0;
+        self->num_edges = 0;
+        self->version = 0;
+        self->hash = 0;
+        self->parent = NULL;
+        self->rank = NULL;
+        self->components = 0;
+    }
+    return (PyObject*)self;
+}
+
+
+// Wczytuje graf z formatu sparse6. Powtrzone krawdzie i ptle s pomijane: wikszy
+// koniec krawdzi nigdy nie maleje, wic wystarczy pamita dla kadego wierzchoka u
+// ostatni wierzchoek v, z ktrym u zostao ju poczone.
+static int adjacencyListLoadSparse6(AdjacencyList* self, const char* text, Py_ssize_t length) {
+    Sparse6Reader reader;
+
+    if (sparse6Header(&reader, text, length) < 0) {
+        return -1;
+    }
+
+    int n = reader.n;
+    int* last = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    if (last == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+    if (n > 0 && (ensureCapacity(self, n - 1) < 0 || nodePoolReserve(&self->pool, n) < 0)) {
+        goto error;
+    }
+
+    for (int i = 0; i < n; i++) {
+        last[i] = -1;
+        self->adj_list[i] = createNode(&self->pool, i);
+        self->hash ^= vertexKey(i);
+    }
+    self->num_vertices = n;
+
+    int u, v, result;
+    while ((result = sparse6Next(&reader, &u, &v)) > 0) {
+        if (u != v && last[u] != v) {
+            last[u] = v;
+            if (addEdge(self, u, v) < 0) {
+                goto error;
+            }
+        }
+    }
+
+    free(last);
+    if (result < 0) {
+        sparse6CharacterError();
+        return -1;
+    }
+    return 0;
+
+error:
+    free(last);
+    return -1;
+}
+
+// Wczytuje graf zapisany w formacie g6 albo sparse6 (tekst zaczynajcy si od ':'),
+// bez koczcego znaku nowej linii, zastpujc dotychczasow zawarto.
+static int adjacencyListLoadG6(AdjacencyList* self, const char* text, Py_ssize_t length) {
+    forestInvalidate(self);
+    clearNeighborIndexes(self);
+    nodePoolClear(&self->pool);
+    self->num_vertices = 0;
+    self->num_edges = 0;
+    self->version++;
+    self->hash = 0;
+    if (self->capacity > 0) {
+        memset(self->adj_list, 0, (size_t)self->capacity * sizeof(Node*));
+        memset(self->degree, 0, (size_t)self->capacity * sizeof(int));
+    }
+
+    if (rejectDigraph6(text, length) < 0) {
+        return -1;
+    }
+    if (length > 0 && text[0] == ':') {
+        return adjacencyListLoadSparse6(self, text, length);
+    }
+
+    if (length > 0 && text[0] != '?') {
+        int num_vertices;
+        const char* body = g6Header(text, length, &num_vertices);
+
+        if (body == NULL) {
+            return -1;
+        }
+
+        // Jedna alokacja na wszystkie wzy: wartownik kadego wierzchoka
+        // plus dwa wzy na kad krawd zakodowan w tekcie
+        long long bodyLength = ((long long)num_vertices * (num_vertices - 1) / 2 + 5) / 6;
+        long long edgeBits = 0;
+        for (long long j = 0; j < bodyLength; j++) {
+            edgeBits += POPCOUNT64((uint64_t)(body[j] - 63) & 0x3F);
+        }
+        if (num_vertices + 2 * edgeBits > INT_MAX) {
+            PyErr_SetString(PyExc_ValueError, "Graf ma zbyt wiele krawdzi");
+            return -1;
+        }
+        if (ensureCapacity(self, num_vertices - 1) < 0 ||
+            nodePoolReserve(&self->pool, (int)(num_vertices + 2 * edgeBits)) < 0) {
+            return -1;
+        }
+
+        for (int i = 0; i < num_vertices; i++) {
+            Node* newNode = createNode(&self->pool, i);
+            if (newNode == NULL) {
+                PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia wierzchoka");
+                return -1;
+            }
+            self->adj_list[i] = newNode;
+            self->hash ^= vertexKey(i);
+        }
+        self->num_vertices = num_vertices;
+
+        int c = 0;
+        long long i = 0;
+        int k = 0;
+
+        for (int v = 1; v < num_vertices; v++) {
+            for (int u = 0; u < v; u++) {
+                if (k == 0) {
+                    c = body[i++] - 63;
+                    k = 6;
+                }
+                k--;
+
+                if ((c & (1 << k)) != 0) {
+                    if (addEdge(self, u, v) < 0) {
+                        return -1;
+                    }
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int AdjacencyList_init(AdjacencyList* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "text", NULL };
+    char* text = "?";
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", kwlist, &text)) {
+        return -1;
+    }
+
+    return adjacencyListLoadG6(self, text, (Py_ssize_t)strlen(text));
+}
+
+
+// Konstruktor wywoywany przez protok vectorcall: AdjacencyList() i AdjacencyList(text)
+// nie tworz krotki argumentw. Argumenty nazwane i podklasy obsuguje zwyke type.__call__.
+static PyTypeObject AdjacencyListType;
+
+#if PY_VERSION_HEX >= 0x03090000
+static PyObject* AdjacencyList_vectorcall(PyObject* type, PyObject* const* args, size_t nargsf, PyObject* kwnames) {
+    Py_ssize_t nargs = PyVectorcall_NARGS(nargsf);
+    PyTypeObject* graphType = (PyTypeObject*)type;
+
+    if (graphType != &AdjacencyListType || nargs > 1 || (kwnames != NULL && PyTuple_GET_SIZE(kwnames) > 0)) {
+        PyObject* tuple = PyTuple_New(nargs);
+        if (tuple == NULL) {
+            return NULL;
+        }
+        for (Py_ssize_t i = 0; i < nargs; i++) {
+            Py_INCREF(args[i]);
+            PyTuple_SET_ITEM(tuple, i, args[i]);
+        }
+        PyObject* kwargs = NULL;
+        if (kwnames != NULL && PyTuple_GET_SIZE(kwnames) > 0) {
+            kwargs = PyDict_New();
+            for (Py_ssize_t i = 0; kwargs != NULL && i < PyTuple_GET_SIZE(kwnames); i++) {
+                if (PyDict_SetItem(kwargs, PyTuple_GET_ITEM(kwnames, i), args[nargs + i]) < 0) {
+                    Py_CLEAR(kwargs);
+                }
+            }
+            if (kwargs == NULL) {
+                Py_DECREF(tuple);
+                return NULL;
+            }
+        }
+        PyObject* result = PyType_Type.tp_call(type, tuple, kwargs);
+        Py_DECREF(tuple);
+        Py_XDECREF(kwargs);
+        return result;
+    }
+
+    const char* text = "?";
+    Py_ssize_t length = 1;
+    if (nargs == 1) {
+        if (!PyUnicode_Check(args[0])) {
+            PyErr_Format(PyExc_TypeError, "AdjacencyList() argument 1 must be str, not %.50s", Py_TYPE(args[0])->tp_name);
+            return NULL;
+        }
+        text = PyUnicode_AsUTF8AndSize(args[0], &length);
+        if (text == NULL) {
+            return NULL;
+        }
+        if ((Py_ssize_t)strlen(text) != length) {
+            PyErr_SetString(PyExc_ValueError, "embedded null character");
+            return NULL;
+        }
+    }
+
+    PyObject* self = AdjacencyList_new(graphType, NULL, NULL);
+    if (self != NULL && adjacencyListLoadG6((AdjacencyList*)self, text, length) < 0) {
+        Py_CLEAR(self);
+    }
+    return self;
+}
+#endif
+
+// Odczytuje jeden albo dwa (gdy v != NULL) indeksy wierzchokw z argumentw metody
+// METH_FASTCALL, z tymi samymi bdami co format "i" w PyArg_ParseTuple, ale bez
+// budowania krotki argumentw.
+static int parseVertexArgs(PyObject* const* args, Py_ssize_t nargs, int* u, int* v) {
+    Py_ssize_t expected = v != NULL ? 2 : 1;
+    if (nargs != expected) {
+        PyErr_Format(PyExc_TypeError, "function takes exactly %zd argument%s (%zd given)",
+            expected, expected == 1 ? "" : "s", nargs);
+        return -1;
+    }
+
+    for (Py_ssize_t i = 0; i < nargs; i++) {
+        long value = PyLong_AsLong(args[i]);
+        if (value == -1 && PyErr_Occurred()) {
+            return -1;
+        }
+        if (value > INT_MAX || value < INT_MIN) {
+            PyErr_SetString(PyExc_OverflowError, value > 0 ? "signed integer is greater than maximum" : "signed integer is less than minimum");
+            return -1;
+        }
+        *(i == 0 ? u : v) = (int)value;
+    }
+    return 0;
+}
+
+static int adjacencyListOrder(AdjacencyList* self) {
+    return self->num_vertices;
+}
+
+static PyObject *number_of_vertices(AdjacencyList *self) {
+    return PyLong_FromLong(adjacencyListOrder(self));
+}
+
+static PyObject* vertices(AdjacencyList* self) {
+    PyObject* vertex_set = PySet_New(NULL);
+
+    if (vertex_set == NULL)
+    {
+        PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia zbioru dla wierzchokw");
+        return NULL;
+    }
+
+    for (int i = 0; i < self->capacity; i++)
+    {
+        if (self->adj_list[i] != NULL) {
+            PyObject* vertex = PyLong_FromLong(i);
+
+            if (vertex == NULL)
+            {
+                Py_DECREF(vertex_set);
+                PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia wierzchoka");
+                return NULL;
+            }
+            PySet_Add(vertex_set, vertex);
+            Py_DECREF(vertex);
+        }
+    }
+
+    return vertex_set;
+}
+
+static PyObject* vertex_degree(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int vertex;
+
+    if (parseVertexArgs(args, nargs, &vertex, NULL) < 0) {
+        return NULL;
+    }
+
+    if (vertex < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    return PyLong_FromLong(vertex < self->capacity ? self->degree[vertex] : 0);
+}
+
+
+
+static PyObject* vertex_neighbors(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int vertex;
+
+    if (parseVertexArgs(args, nargs, &vertex, NULL) < 0) {
+        return NULL;
+    }
+
+    if (vertex < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    PyObject* neighbors_set = PySet_New(NULL);
+
+    if (neighbors_set == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "Nie udao si utworzy zbioru ssiadw");
+        return NULL;
+    }
+
+    Node* current = adjacency(self, vertex);
+
+    while (current != NULL) {
+        int neighbor = current->vertex;
+        if (neighbor == vertex) {
+            current = current->next;
+            continue;
+        }
+        
+        PyObject* neighbor_py = PyLong_FromLong(neighbor);
+
+        if (neighbor_py == NULL) {
+            Py_DECREF(neighbors_set);
+            PyErr_SetString(PyExc_RuntimeError, "Nie udao si utworzy obiektu ssiada");
+            return NULL;
+        }
+
+        int result = PySet_Add(neighbors_set, neighbor_py);
+        Py_DECREF(neighbor_py);
+
+        if (result < 0) {
+            Py_DECREF(neighbors_set);
+            PyErr_SetString(PyExc_RuntimeError, "Nie udao si doda ssiada do zbioru ssiadw");
+            return NULL;
+        }
+
+        current = current->next;
+    }
+
+    return neighbors_set;
+}
+
+static PyObject* add_vertex(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int vertex;
+
+    if (parseVertexArgs(args, nargs, &vertex, NULL) < 0) {
+        return NULL;
+    }
+
+    if (vertex < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    if (ensureCapacity(self, vertex) < 0) {
+        return NULL;
+    }
+
+    if (self->adj_list[vertex] != NULL) {
+        PyErr_SetString(PyExc_ValueError, "Wierzchoek ju istnieje w grafie");
+        return NULL;
+    }
+
+    Node* newNode = createNode(&self->pool, vertex);
+    if (newNode == NULL) {
+        return NULL;  
+    }
+    self->adj_list[vertex] = newNode;
+    self->num_vertices++;
+    self->version++;
+    self->hash ^= vertexKey(vertex);
+    self->components++;
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+
+int deleteNode(AdjacencyList* self, int vertex, int key);
+
+// Usuwa istniejcy wierzchoek wraz ze wszystkimi incydentnymi krawdziami.
+static void removeVertex(AdjacencyList* self, int vertex) {
+    forestInvalidate(self);
+    self->num_vertices--;
+    self->num_edges -= self->degree[vertex];
+    self->version++;
+    self->hash ^= vertexKey(vertex);
+    self->degree[vertex] = 0;
+    dropNeighborIndex(self, vertex);
+
+    Node* current = self->adj_list[vertex];
+    self->adj_list[vertex] = NULL;
+    while (current != NULL) {
+        int neighbor = current->vertex;
+        Node* next = current->next;
+        freeNode(&self->pool, current);
+        current = next;
+
+        if (neighbor != vertex && deleteNode(self, neighbor, vertex)) {
+            self->hash ^= edgeKey(neighbor, vertex);
+        }
+    }
+}
+
+static PyObject* delete_vertex(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int vertex;
+
+    if (parseVertexArgs(args, nargs, &vertex, NULL) < 0) {
+        return NULL;
+    }
+
+    if (vertex < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    if (adjacency(self, vertex) == NULL) {
+        PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje");
+        return NULL;
+    }
+
+    removeVertex(self, vertex);
+
+    Py_INCREF(Py_None);
+    return Py_None;
+}
+
+
+
+static PyObject* number_of_edges(AdjacencyList* self) {
+    return PyLong_FromLongLong(self->num_edges);
+}
+
+static PyObject* edges(AdjacencyList* self) {
+    PyObject* edges_set = PySet_New(NULL);
+
+    if (edges_set == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "Nie mona zaalokowa pamici dla zbioru (set)");
+        return NULL;
+    }
+
+    for (int u = 0; u < self->capacity; u++) {
+        Node* current = self->adj_list[u];
+
+        while (current != NULL) {
+            int v = current->vertex;
+            if (u < v) {
+                PyObject* edge_tuple = Py_BuildValue("(ii)", u, v);
+                if (edge_tuple == NULL) {
+                    Py_DECREF(edges_set);
+                    PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia krotki (tuple)");
+                    return NULL;
+                }
+
+                int result = PySet_Add(edges_set, edge_tuple);
+                Py_DECREF(edge_tuple);
+
+                if (result < 0) {
+                    Py_DECREF(edges_set);
+                    PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas dodawania krotki do zbioru");
+                    return NULL;
+                }
+            }
+
+            current = current->next;
+        }
+    }
+
+    return edges_set;
+}
+
+// Leniwy iterator po ssiadach wierzchoka (iter_neighbors) albo po krawdziach grafu
+// (iter_edges). Przechodzi bezporednio po listach ssiedztwa, wic nie tworzy zbioru;
+// zmiana grafu w trakcie iteracji (wykrywana po polu version) koczy si bdem.
+typedef struct {
+    PyObject_HEAD
+    AdjacencyList* graph;        // NULL po wyczerpaniu iteratora
+    unsigned long long version;
+    int vertex;                  // wierzchoek, ktrego list przegldamy
+    int edges;                   // 1 dla iter_edges: zwracane s pary (vertex, v) z vertex < v
+    Node* current;
+    PyObject* first;             // obiekt int dla vertex, wsplny dla wszystkich jego krawdzi
+} AdjacencyListIterator;
+
+static PyTypeObject AdjacencyListIteratorType;
+
+static PyObject* adjacencyListIterator(AdjacencyList* graph, int vertex, int edges) {
+    AdjacencyListIterator* iterator = PyObject_New(AdjacencyListIterator, &AdjacencyListIteratorType);
+    if (iterator == NULL) {
+        return NULL;
+    }
+    Py_INCREF(graph);
+    iterator->graph = graph;
+    iterator->version = graph->version;
+    iterator->vertex = vertex;
+    iterator->edges = edges;
+    iterator->current = edges ? NULL : adjacency(graph, vertex);
+    iterator->first = NULL;
+    return (PyObject*)iterator;
+}
+
+static void AdjacencyListIterator_dealloc(AdjacencyListIterator* self) {
+    Py_XDECREF(self->graph);
+    Py_XDECREF(self->first);
+    PyObject_Del(self);
+}
+
+static PyObject* AdjacencyListIterator_next(AdjacencyListIterator* self) {
+    AdjacencyList* graph = self->graph;
+    if (graph == NULL) {
+        return NULL;
+    }
+    if (graph->version != self->version) {
+        PyErr_SetString(PyExc_RuntimeError, "Graf zosta zmieniony podczas iteracji");
+        return NULL;
+    }
+
+    if (!self->edges) {
+        // Wartownik (wze z numerem samego wierzchoka) nie jest ssiadem
+        while (self->current != NULL && self->current->vertex == self->vertex) {
+            self->current = self->current->next;
+        }
+        if (self->current == NULL) {
+            Py_CLEAR(self->graph);
+            return NULL;
+        }
+        int neighbor = self->current->vertex;
+        self->current = self->current->next;
+        return PyLong_FromLong(neighbor);
+    }
+
+    while (1) {
+        while (self->current != NULL && self->current->vertex <= self->vertex) {
+            self->current = self->current->next;
+        }
+        if (self->current != NULL) {
+            break;
+        }
+        do {
+            self->vertex++;
+        } while (self->vertex < graph->capacity && graph->adj_list[self->vertex] == NULL);
+        if (self->vertex >= graph->capacity) {
+            Py_CLEAR(self->first);
+            Py_CLEAR(self->graph);
+            return NULL;
+        }
+        self->current = graph->adj_list[self->vertex];
+        Py_CLEAR(self->first);
+    }
+
+    if (self->first == NULL && (self->first = PyLong_FromLong(self->vertex)) == NULL) {
+        return NULL;
+    }
+    PyObject* second = PyLong_FromLong(self->current->vertex);
+    if (second == NULL) {
+        return NULL;
+    }
+    self->current = self->current->next;
+
+    PyObject* edge = PyTuple_New(2);
+    if (edge == NULL) {
+        Py_DECREF(second);
+        return NULL;
+    }
+    Py_INCREF(self->first);
+    PyTuple_SET_ITEM(edge, 0, self->first);
+    PyTuple_SET_ITEM(edge, 1, second);
+    return edge;
+}
+
+static PyTypeObject AdjacencyListIteratorType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "simple_graphs.AdjacencyListIterator", /* tp_name */
+    sizeof(AdjacencyListIterator),     /* tp_basicsize */
+    0,                                 /* tp_itemsize */
+    (destructor)AdjacencyListIterator_dealloc, /* tp_dealloc */
+    0,                                 /* tp_vectorcall_offset */
+    0,                                 /* tp_getattr */
+    0,                                 /* tp_setattr */
+    0,                                 /* tp_as_async */
+    0,                                 /* tp_repr */
+    0,                                 /* tp_as_number */
+    0,                                 /* tp_as_sequence */
+    0,                                 /* tp_as_mapping */
+    0,                                 /* tp_hash */
+    0,                                 /* tp_call */
+    0,                                 /* tp_str */
+    0,                                 /* tp_getattro */
+    0,                                 /* tp_setattro */
+    0,                                 /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                /* tp_flags */
+    0,                                 /* tp_doc */
+    0,                                 /* tp_traverse */
+    0,                                 /* tp_clear */
+    0,                                 /* tp_richcompare */
+    0,                                 /* tp_weaklistoffset */
+    PyObject_SelfIter,                 /* tp_iter */
+    (iternextfunc)AdjacencyListIterator_next, /* tp_iternext */
+};
+
+static PyObject* iter_neighbors(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int vertex;
+
+    if (parseVertexArgs(args, nargs, &vertex, NULL) < 0) {
+        return NULL;
+    }
+
+    if (vertex < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    return adjacencyListIterator(self, vertex, 0);
+}
+
+static PyObject* iter_edges(AdjacencyList* self) {
+    return adjacencyListIterator(self, -1, 1);
+}
+
+static int compareInt32(const void* a, const void* b) {
+    int32_t x = *(const int32_t*)a, y = *(const int32_t*)b;
+    return (x > y) - (x < y);
+}
+
+static PyObject* adjacency_csr(AdjacencyList* self);
+
+// Zwraca krawdzie jako paski memoryview int32 [u0, v0, u1, v1, ...] z u < v,
+// posortowany po u, a potem po v (np. numpy.frombuffer(...).reshape(-1, 2)). W przeciwiestwie
+// do adjacency_csr pary zawieraj numery wierzchokw, tak jak edges().
+static PyObject* edge_array(AdjacencyList* self) {
+    Py_ssize_t count = 0;
+    for (int u = 0; u < self->capacity; u++) {
+        for (Node* current = self->adj_list[u]; current != NULL; current = current->next) {
+            count += current->vertex > u;
+        }
+    }
+
+    PyObject* bytes = PyBytes_FromStringAndSize(NULL, 2 * count * (Py_ssize_t)sizeof(int32_t));
+    if (bytes == NULL) {
+        return NULL;
+    }
+    int32_t* pairs = (int32_t*)PyBytes_AS_STRING(bytes);
+
+    // Najpierw zapisujemy samych ssiadw v > u w drugiej poowie bufora, sortujemy
+    // je w obrbie wierzchoka, a potem rozkadamy na pary
+    int32_t* higher = pairs + count;
+    Py_ssize_t position = 0;
+    for (int u = 0; u < self->capacity; u++) {
+        Py_ssize_t first = position;
+        for (Node* current = self->adj_list[u]; current != NULL; current = current->next) {
+            if (current->vertex > u) {
+                higher[position++] = current->vertex;
+            }
+        }
+        qsort(higher + first, (size_t)(position - first), sizeof(int32_t), compareInt32);
+    }
+
+    position = 0;
+    for (int u = 0; u < self->capacity; u++) {
+        for (Node* current = self->adj_list[u]; current != NULL; current = current->next) {
+            if (current->vertex > u) {
+                int32_t v = higher[position];
+                pairs[2 * position] = u;
+                pairs[2 * position + 1] = v;
+                position++;
+            }
+        }
+    }
+
+    return bytesView(bytes, "i");
+}
+
+static PyObject* is_edge(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int u, v;
+
+    if (parseVertexArgs(args, nargs, &u, &v) < 0) {
+        return NULL;
+    }
+
+    if (u < 0 || v < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    return PyBool_FromLong(hasEdge(self, u, v));
+}
+
+
+static PyObject* add_edge(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int src, dest;
+
+    if (parseVertexArgs(args, nargs, &src, &dest) < 0) {
+        return NULL;
+    }
+
+    if (src < 0 || dest < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    // Brakujce koce s dodawane jako wierzchoki (jak w add_edges), wic pozostaj
+    // w grafie take po usuniciu krawdzi
+    if (insertVertex(self, src) < 0 || insertVertex(self, dest) < 0) {
+        return NULL;
+    }
+
+    // Ptle s pomijane (jak w add_edges), a krawd ju istniejca nie jest dodawana ponownie
+    if (src != dest && !hasEdge(self, src, dest) && addEdge(self, src, dest) < 0) {
+        return NULL;
+    }
+
+    return PyBool_FromLong(1);
+}
+
+// Usuwa key (rny od vertex) z listy ssiedztwa wierzchoka vertex. Zwraca 1, jeli key
+// by na licie.
+int deleteNode(AdjacencyList* self, int vertex, int key) {
+    Node* temp = findNeighbor(self, vertex, key);
+
+    if (temp == NULL) {
+        return 0;
+    }
+    self->version++;
+
+    NeighborIndex** index = &self->neighbor_index[vertex];
+    if (*index != NULL) {
+        neighborIndexRemove(*index, key);
+    }
+
+    // Bez poprzednika: nastpny wze (key != vertex, a na kocu kadej listy jest
+    // wartownik, wic istnieje) jest przenoszony w miejsce usuwanego, a indeks wskazuje
+    // jego nowe pooenie
+    Node* next = temp->next;
+    temp->vertex = next->vertex;
+    temp->next = next->next;
+    indexNeighbor(self, vertex, temp);
+
+    freeNode(&self->pool, next);
+    self->degree[vertex]--;
+    if (*index != NULL && self->degree[vertex] < NEIGHBOR_INDEX_THRESHOLD / 2) {
+        dropNeighborIndex(self, vertex);
+    }
+    return 1;
+}
+
+static PyObject* delete_edge(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int u, v;
+
+    if (parseVertexArgs(args, nargs, &u, &v) < 0) {
+        return NULL;
+    }
+
+    if (u < 0 || v < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    if (adjacency(self, u) == NULL || adjacency(self, v) == NULL) {
+        PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje w grafie");
+        return NULL;
+    }
+
+    // Sprawdzamy przed jakkolwiek zmian; ptli nie ma w grafie
+    if (!hasEdge(self, u, v)) {
+        PyErr_SetString(PyExc_ValueError, "Krawd nie istnieje w grafie");
+        return NULL;
+    }
+
+    forestInvalidate(self);
+    deleteNode(self, u, v);
+    deleteNode(self, v, u);
+    self->num_edges--;
+    self->hash ^= edgeKey(u, v);
+
+    return PyBool_FromLong(1);
+}
+
+// Dodaje wszystkie krawdzie z bufora albo obiektu iterowalnego w jednej ptli. Brakujce
+// koce s dodawane jako wierzchoki, a krawdzie ju istniejce i ptle pomijane.
+// Zwraca liczb dodanych krawdzi.
+static PyObject* add_edges(AdjacencyList* self, PyObject* edges) {
+    int* pairs;
+    Py_ssize_t count = readEdgePairs(edges, INT_MAX, &pairs);
+    if (count < 0) {
+        return NULL;
+    }
+
+    int maxVertex = -1;
+    for (Py_ssize_t i = 0; i < 2 * count; i++) {
+        if (pairs[i] > maxVertex) {
+            maxVertex = pairs[i];
+        }
+    }
+    // Jedna alokacja na dwa wzy kadej krawdzi
+    if ((maxVertex >= 0 && ensureCapacity(self, maxVertex) < 0) ||
+        (count <= INT_MAX / 2 && nodePoolReserve(&self->pool, (int)(2 * count)) < 0)) {
+        free(pairs);
+        return NULL;
+    }
+
+    long long added = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int u = pairs[2 * i];
+        int v = pairs[2 * i + 1];
+        if (insertVertex(self, u) < 0 || insertVertex(self, v) < 0) {
+            free(pairs);
+            return NULL;
+        }
+        if (u != v && !hasEdge(self, u, v)) {
+            if (addEdge(self, u, v) < 0) {
+                free(pairs);
+                return NULL;
+            }
+            added++;
+        }
+    }
+
+    free(pairs);
+    return PyLong_FromLongLong(added);
+}
+
+// Usuwa wszystkie krawdzie z bufora albo obiektu iterowalnego. Najpierw sprawdza, e
+// kada krawd istnieje, wic przy bdzie graf pozostaje niezmieniony; powtrzenia
+// tej samej krawdzi s pomijane. Zwraca liczb usunitych krawdzi.
+static PyObject* delete_edges(AdjacencyList* self, PyObject* edges) {
+    int* pairs;
+    Py_ssize_t count = readEdgePairs(edges, INT_MAX, &pairs);
+    if (count < 0) {
+        return NULL;
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int u = pairs[2 * i];
+        int v = pairs[2 * i + 1];
+        if (adjacency(self, u) == NULL || adjacency(self, v) == NULL) {
+            free(pairs);
+            PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje w grafie");
+            return NULL;
+        }
+        if (u == v || !hasEdge(self, u, v)) {
+            free(pairs);
+            PyErr_SetString(PyExc_ValueError, "Krawd nie istnieje w grafie");
+            return NULL;
+        }
+    }
+
+    forestInvalidate(self);
+
+    long long deleted = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int u = pairs[2 * i];
+        int v = pairs[2 * i + 1];
+        if (deleteNode(self, u, v)) {
+            deleteNode(self, v, u);
+            self->num_edges--;
+            self->hash ^= edgeKey(u, v);
+            deleted++;
+        }
+    }
+
+    free(pairs);
+    return PyLong_FromLongLong(deleted);
+}
+
+// Zapisuje listy ssiedztwa w postaci CSR (wierzchoki numerowane kolejno od 0 jak w freeze,
+// bez wartownikw) do tablic przydzielonych przez malloc. Zwraca liczb wierzchokw albo -1.
+static int adjacencyListArrays(AdjacencyList* self, int64_t** offsets, int32_t** targets) {
+    int* label = (int*)malloc(((size_t)self->capacity + 1) * sizeof(int));
+    *offsets = NULL;
+    *targets = NULL;
+    if (label == NULL) {
+        return -1;
+    }
+
+    int n = 0;
+    for (int v = 0; v < self->capacity; v++) {
+        label[v] = self->adj_list[v] != NULL ? n++ : -1;
+    }
+
+    // Listy s przechodzone tylko raz; rozmiar tablicy ssiadw wynika z licznika krawdzi
+    *offsets = (int64_t*)malloc(((size_t)n + 1) * sizeof(int64_t));
+    *targets = (int32_t*)malloc(((size_t)self->num_edges * 2 + 1) * sizeof(int32_t));
+    if (*offsets == NULL || *targets == NULL) {
+        free(label);
+        free(*offsets);
+        free(*targets);
+        *offsets = NULL;
+        *targets = NULL;
+        return -1;
+    }
+
+    int64_t position = 0;
+    (*offsets)[0] = 0;
+    for (int v = 0; v < self->capacity; v++) {
+        if (label[v] < 0) {
+            continue;
+        }
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            if (current->vertex != v) {
+                (*targets)[position++] = label[current->vertex];
+            }
+        }
+        (*offsets)[label[v] + 1] = position;
+    }
+
+    free(label);
+    return n;
+}
+
+// Skadowe spjnoci (i dwudzielno) liczone silnikiem BFS na tablicach CSR grafu.
+// Zwraca -1, gdy brakuje pamici.
+static int adjacencyListComponents(AdjacencyList* self, int* bipartite) {
+    int64_t* offsets;
+    int32_t* targets;
+    int n = adjacencyListArrays(self, &offsets, &targets);
+    if (n < 0) {
+        return -1;
+    }
+
+    int components = csrArraysComponents(n, offsets, targets, bipartite);
+    free(offsets);
+    free(targets);
+    return components;
+}
+
+static PyObject* is_bipartite(AdjacencyList* self) {
+    int bipartite;
+    if (adjacencyListComponents(self, &bipartite) < 0) {
+        return PyErr_NoMemory();
+    }
+    return PyBool_FromLong(bipartite);
+}
+
+// Zwraca pierwszy (najmniejszy) istniejcy wierzchoek albo -1 dla grafu bez wierzchokw.
+static int firstVertex(AdjacencyList* self) {
+    for (int i = 0; i < self->capacity; i++) {
+        if (self->adj_list[i] != NULL) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+static PyObject* complement(AdjacencyList* self) {
+    AdjacencyList* result = (AdjacencyList*)emptyGraph(Py_TYPE(self));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    // marked[u] == v + 1 <=> u jest ssiadem v
+    int* marked = (int*)calloc((size_t)self->capacity + 1, sizeof(int));
+    if (marked == NULL) {
+        Py_DECREF(result);
+        return PyErr_NoMemory();
+    }
+
+    for (int v = 0; v < self->capacity; v++) {
+        if (self->adj_list[v] == NULL) {
+            continue;
+        }
+        if (insertVertex(result, v) < 0) {
+            goto error;
+        }
+
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            marked[current->vertex] = v + 1;
+        }
+        for (int u = 0; u < v; u++) {
+            if (self->adj_list[u] != NULL && marked[u] != v + 1) {
+                if (addEdge(result, u, v) < 0) {
+                    goto error;
+                }
+            }
+        }
+    }
+
+    free(marked);
+    return (PyObject*)result;
+
+error:
+    free(marked);
+    Py_DECREF(result);
+    return NULL;
+}
+
+// Buduje las od nowa: kady istniejcy wierzchoek jest osobnym zbiorem, potem czymy
+// koce wszystkich krawdzi.
+static int forestBuild(AdjacencyList* self) {
+    int capacity = self->capacity;
+    self->parent = (int*)malloc(((size_t)capacity + 1) * sizeof(int));
+    self->rank = (unsigned char*)calloc((size_t)capacity + 1, 1);
+    if (self->parent == NULL || self->rank == NULL) {
+        forestInvalidate(self);
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    self->components = 0;
+    for (int v = 0; v < capacity; v++) {
+        self->parent[v] = v;
+        self->components += self->adj_list[v] != NULL;
+    }
+    for (int v = 0; v < capacity; v++) {
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            if (current->vertex < v) {
+                forestUnion(self, current->vertex, v);
+            }
+        }
+    }
+    return 0;
+}
+
+static PyObject* connected_components(AdjacencyList* self) {
+    if (self->parent == NULL && forestBuild(self) < 0) {
+        return NULL;
+    }
+    return PyLong_FromLong(self->components);
+}
+
+// Tworzy graf o wierzchokach 0..n-1 i rezerwuje wzy na podan liczb krawdzi.
+static AdjacencyList* graphWithVertices(PyTypeObject* type, int n, long long edgeCount) {
+    AdjacencyList* result = (AdjacencyList*)emptyGraph(type);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    if (n > 0) {
+        if (n + 2 * edgeCount > INT_MAX) {
+            Py_DECREF(result);
+            PyErr_SetString(PyExc_ValueError, "Graf ma zbyt wiele krawdzi");
+            return NULL;
+        }
+        if (ensureCapacity(result, n - 1) < 0 ||
+            nodePoolReserve(&result->pool, (int)(n + 2 * edgeCount)) < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (insertVertex(result, i) < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+
+    return result;
+}
+
+// Dodaje krawd, o ile nie jest ptl i jeszcze nie istnieje.
+static int addEdgeOnce(AdjacencyList* self, int u, int v) {
+    if (u == v || hasEdge(self, u, v)) {
+        return 0;
+    }
+    return addEdge(self, u, v);
+}
+
+static PyObject* create_complete_bipartite(PyTypeObject* type, PyObject* args) {
+    int n, m;
+
+    if (!PyArg_ParseTuple(args, "ii", &n, &m)) {
+        return NULL;
+    }
+
+    if (n < 0 || m < 0 || (long long)n + m > INT_MAX) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return NULL;
+    }
+
+    AdjacencyList* result = graphWithVertices(type, n + m, (long long)n * m);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < n; i++) {
+        for (int j = n; j < n + m; j++) {
+            if (addEdge(result, i, j) < 0) {
+                Py_DECREF(result);
+                return NULL;
+            }
+        }
+    }
+
+    return (PyObject*)result;
+}
+
+static PyObject* create_cycle(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return NULL;
+    }
+
+    AdjacencyList* result = graphWithVertices(type, n, n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < n; i++) {
+        if (addEdgeOnce(result, i, (i + 1) % n) < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)result;
+}
+
+static PyObject* create_path(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return NULL;
+    }
+
+    AdjacencyList* result = graphWithVertices(type, n, n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int i = 1; i < n; i++) {
+        if (addEdge(result, i - 1, i) < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)result;
+}
+
+static PyObject* create_star(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return NULL;
+    }
+
+    AdjacencyList* result = graphWithVertices(type, n, n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int i = 1; i < n; i++) {
+        if (addEdge(result, 0, i) < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)result;
+}
+
+static PyObject* create_wheel(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return NULL;
+    }
+
+    AdjacencyList* result = graphWithVertices(type, n, 2 * (long long)n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    // Wierzchoki 0..n-2 tworz obrcz, a n-1 jest rodkiem koa
+    for (int i = 0; i < n - 1; i++) {
+        if (addEdgeOnce(result, i, n - 1) < 0 || addEdgeOnce(result, i, (i + 1) % (n - 1)) < 0) {
+            Py_DECREF(result);
+            return NULL;
+        }
+    }
+
+    return (PyObject*)result;
+}
+
+// Graf losowy z modelu G(n, p), G(n, m) albo losowy graf regularny; krawdzie trafiaj
+// do list przygotowanych z gry dla wszystkich wierzchokw i krawdzi.
+static PyObject* randomAdjacencyList(PyTypeObject* type, PyObject* args, PyObject* kwds, int model) {
+    int n;
+    int* pairs;
+    long long count = randomGraphPairs(model, args, kwds, INT_MAX, &n, &pairs);
+    if (count < 0) {
+        return NULL;
+    }
+
+    AdjacencyList* result = graphWithVertices(type, n, count);
+    for (long long i = 0; result != NULL && i < count; i++) {
+        if (addEdge(result, pairs[2 * i], pairs[2 * i + 1]) < 0) {
+            Py_DECREF(result);
+            result = NULL;
+        }
+    }
+
+    free(pairs);
+    return (PyObject*)result;
+}
+
+static PyObject* create_gnp(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    return randomAdjacencyList(type, args, kwds, RANDOM_GNP);
+}
+
+static PyObject* create_gnm(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    return randomAdjacencyList(type, args, kwds, RANDOM_GNM);
+}
+
+static PyObject* create_random_regular(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    return randomAdjacencyList(type, args, kwds, RANDOM_REGULAR);
+}
+
+// Tworzy nierosncy cig stopni z histogramu (histogram[d] = liczba wierzchokw stopnia d).
+static PyObject* degreeList(const int* histogram, int maxDegree, int count) {
+    PyObject* result = PyList_New(count);
+    int i = 0;
+
+    for (int d = maxDegree; result != NULL && d >= 0; d--) {
+        if (histogram[d] == 0) {
+            continue;
+        }
+        PyObject* degree = PyLong_FromLong(d);
+        if (degree == NULL) {
+            Py_CLEAR(result);
+            break;
+        }
+        for (int k = 0; k < histogram[d]; k++) {
+            Py_INCREF(degree);
+            PyList_SET_ITEM(result, i++, degree);
+        }
+        Py_DECREF(degree);
+    }
+    return result;
+}
+
+// Sortowanie przez zliczanie: stopnie nale do przedziau 0..max, wic cig
+// powstaje w czasie O(n + max) zamiast O(n log n).
+static PyObject* degree_sequence(AdjacencyList* self) {
+    int count = 0, maxDegree = 0;
+    for (int v = 0; v < self->capacity; v++) {
+        if (self->adj_list[v] != NULL) {
+            count++;
+            if (self->degree[v] > maxDegree) {
+                maxDegree = self->degree[v];
+            }
+        }
+    }
+
+    int* histogram = (int*)calloc((size_t)maxDegree + 1, sizeof(int));
+    if (histogram == NULL) {
+        return PyErr_NoMemory();
+    }
+    for (int v = 0; v < self->capacity; v++) {
+        if (self->adj_list[v] != NULL) {
+            histogram[self->degree[v]]++;
+        }
+    }
+
+    PyObject* result = degreeList(histogram, maxDegree, count);
+    free(histogram);
+    return result;
+}
+
+static PyObject* edge_contraction(AdjacencyList* self, PyObject* const* args, Py_ssize_t nargs) {
+    int u, v;
+
+    if (parseVertexArgs(args, nargs, &u, &v) < 0) {
+        return NULL;
+    }
+
+    if (u < 0 || v < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    AdjacencyList* result = (AdjacencyList*)emptyGraph(Py_TYPE(self));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    // Wierzchoek u znika, a jego krawdzie zostaj przepite do v
+    for (int w = 0; w < self->capacity; w++) {
+        if (self->adj_list[w] != NULL && w != u) {
+            if (insertVertex(result, w) < 0) {
+                Py_DECREF(result);
+                return NULL;
+            }
+        }
+    }
+
+    for (int a = 0; a < self->capacity; a++) {
+        for (Node* current = self->adj_list[a]; current != NULL; current = current->next) {
+            int b = current->vertex;
+            if (b <= a || (a == u && b == v) || (a == v && b == u)) {
+                continue;
+            }
+
+            int a2 = a == u ? v : a;
+            int b2 = b == u ? v : b;
+            if (addEdgeOnce(result, a2, b2) < 0) {
+                Py_DECREF(result);
+                return NULL;
+            }
+        }
+    }
+
+    return (PyObject*)result;
+}
+
+static PyObject* induced_subgraph(AdjacencyList* self, PyObject* vertex_set) {
+    char* selected = (char*)calloc((size_t)self->capacity + 1, 1);
+    if (selected == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    PyObject* iterator = PyObject_GetIter(vertex_set);
+    if (iterator == NULL) {
+        free(selected);
+        return NULL;
+    }
+
+    PyObject* item;
+    while ((item = PyIter_Next(iterator)) != NULL) {
+        long vertex = PyLong_AsLong(item);
+        Py_DECREF(item);
+        if (vertex == -1 && PyErr_Occurred()) {
+            break;
+        }
+        if (vertex >= 0 && vertex < self->capacity) {
+            selected[vertex] = 1;
+        }
+    }
+    Py_DECREF(iterator);
+    if (PyErr_Occurred()) {
+        free(selected);
+        return NULL;
+    }
+
+    AdjacencyList* result = (AdjacencyList*)emptyGraph(Py_TYPE(self));
+    if (result == NULL) {
+        free(selected);
+        return NULL;
+    }
+
+    for (int v = 0; v < self->capacity; v++) {
+        if (self->adj_list[v] == NULL || !selected[v]) {
+            continue;
+        }
+        if (insertVertex(result, v) < 0) {
+            goto error;
+        }
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            int u = current->vertex;
+            if (u < v && selected[u]) {
+                if (addEdge(result, u, v) < 0) {
+                    goto error;
+                }
+            }
+        }
+    }
+
+    free(selected);
+    return (PyObject*)result;
+
+error:
+    free(selected);
+    Py_DECREF(result);
+    return NULL;
+}
+
+static PyObject* is_complete_bipartite(AdjacencyList* self) {
+    int first = firstVertex(self);
+    if (first < 0) {
+        PyErr_SetString(PyExc_ValueError, "Graf nie ma wierzchokw");
+        return NULL;
+    }
+
+    // Jedn stron podziau wyznaczaj ssiedzi pierwszego wierzchoka
+    char* side = (char*)calloc((size_t)self->capacity + 1, 1);
+    if (side == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    int sizes[2] = { 0, 0 };
+    for (Node* current = self->adj_list[first]; current != NULL; current = current->next) {
+        if (current->vertex != first) {
+            side[current->vertex] = 1;
+        }
+    }
+    for (int v = 0; v < self->capacity; v++) {
+        if (self->adj_list[v] != NULL) {
+            sizes[(int)side[v]]++;
+        }
+    }
+
+    // Kady wierzchoek musi ssiadowa ze wszystkimi z przeciwnej strony i z nikim ze swojej
+    int result = 1;
+    for (int v = 0; v < self->capacity && result; v++) {
+        if (self->adj_list[v] == NULL) {
+            continue;
+        }
+        int across = 0;
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            int u = current->vertex;
+            if (u == v) {
+                continue;
+            }
+            if (side[u] == side[v]) {
+                result = 0;
+                break;
+            }
+            across++;
+        }
+        if (across != sizes[1 - side[v]]) {
+            result = 0;
+        }
+    }
+
+    free(side);
+    return PyBool_FromLong(result);
+}
+
+static PyObject* is_tree(AdjacencyList* self) {
+    if (self->num_vertices == 0) {
+        PyErr_SetString(PyExc_ValueError, "Graf nie ma wierzchokw");
+        return NULL;
+    }
+
+    if (self->num_edges != self->num_vertices - 1) {
+        Py_RETURN_FALSE;
+    }
+
+    // Majc n - 1 krawdzi, graf jest drzewem dokadnie wtedy, gdy jest spjny
+    int components = adjacencyListComponents(self, NULL);
+    if (components < 0) {
+        return PyErr_NoMemory();
+    }
+    return PyBool_FromLong(components == 1);
+}
+
+// Zapytania o odlegoci na tablicach CSR grafu; wierzchoki numerujemy jak w freeze.
+static PyObject* adjacencyListDistances(AdjacencyList* self, PyObject* args, PyObject* kwds, int query) {
+    int threads = parseThreads(args, kwds);
+    if (threads < 0) {
+        return NULL;
+    }
+
+    int64_t* offsets;
+    int32_t* targets;
+    int n = adjacencyListArrays(self, &offsets, &targets);
+    if (n < 0) {
+        return PyErr_NoMemory();
+    }
+
+    PyObject* result = distanceQuery(n, offsets, targets, query, threads);
+    free(offsets);
+    free(targets);
+    return result;
+}
+
+static PyObject* distance_matrix(AdjacencyList* self, PyObject* args, PyObject* kwds) {
+    return adjacencyListDistances(self, args, kwds, DISTANCE_MATRIX);
+}
+
+static PyObject* eccentricities(AdjacencyList* self, PyObject* args, PyObject* kwds) {
+    return adjacencyListDistances(self, args, kwds, DISTANCE_ECCENTRICITIES);
+}
+
+static PyObject* diameter(AdjacencyList* self, PyObject* args, PyObject* kwds) {
+    return adjacencyListDistances(self, args, kwds, DISTANCE_DIAMETER);
+}
+
+static PyObject* wiener_index(AdjacencyList* self, PyObject* args, PyObject* kwds) {
+    return adjacencyListDistances(self, args, kwds, DISTANCE_WIENER_INDEX);
+}
+
+// Powyej tej liczby wierzchokw wiersze bitowe zajmowayby zbyt duo pamici
+// i trjkty liczymy bezporednio na listach.
+#define TRIANGLE_BITSET_MAX_VERTICES 4096
+
+static PyObject* number_of_triangles(AdjacencyList* self) {
+    if (self->capacity <= TRIANGLE_BITSET_MAX_VERTICES) {
+        int n = self->capacity;
+        int words = (n + 63) / 64;
+        uint64_t* rows = (uint64_t*)calloc((size_t)n * words + 1, sizeof(uint64_t));
+        if (rows == NULL) {
+            return PyErr_NoMemory();
+        }
+
+        for (int u = 0; u < n; u++) {
+            for (Node* current = self->adj_list[u]; current != NULL; current = current->next) {
+                int v = current->vertex;
+                if (v != u) {
+                    rows[(size_t)u * words + v / 64] |= (uint64_t)1 << (v % 64);
+                }
+            }
+        }
+
+        long long triangles = countTriangles(rows, n, words);
+        free(rows);
+        return PyLong_FromLongLong(triangles);
+    }
+
+    int* marked = (int*)calloc((size_t)self->capacity + 1, sizeof(int));
+    if (marked == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    // Kady trjkt u < v < w liczymy raz: od najmniejszego wierzchoka
+    long long triangles = 0;
+    for (int u = 0; u < self->capacity; u++) {
+        for (Node* a = self->adj_list[u]; a != NULL; a = a->next) {
+            marked[a->vertex] = u + 1;
+        }
+        for (Node* a = self->adj_list[u]; a != NULL; a = a->next) {
+            int v = a->vertex;
+            if (v <= u) {
+                continue;
+            }
+            for (Node* b = self->adj_list[v]; b != NULL; b = b->next) {
+                if (b->vertex > v && marked[b->vertex] == u + 1) {
+                    triangles++;
+                }
+            }
+        }
+    }
+
+    free(marked);
+    return PyLong_FromLongLong(triangles);
+}
+
+static PyObject* smoothing(AdjacencyList* self) {
+    AdjacencyList* result = (AdjacencyList*)emptyGraph(Py_TYPE(self));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int v = 0; v < self->capacity; v++) {
+        if (self->adj_list[v] == NULL) {
+            continue;
+        }
+        if (insertVertex(result, v) < 0) {
+            goto error;
+        }
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            if (current->vertex < v && addEdge(result, current->vertex, v) < 0) {
+                goto error;
+            }
+        }
+    }
+    int* degree = result->degree;
+
+    // Zawsze wygadzamy najmniejszy wierzchoek stopnia 2. Po jego usuniciu stopie
+    // mog zmieni tylko jego dwaj ssiedzi, wic wyszukiwanie wznawiamy od najmniejszego
+    // z trzech zmienionych indeksw.
+    int start = 0;
+    while (1) {
+        int x = start;
+        while (x < result->capacity && (result->adj_list[x] == NULL || degree[x] != 2)) {
+            x++;
+        }
+        if (x >= result->capacity) {
+            break;
+        }
+
+        int ends[2], count = 0;
+        for (Node* current = result->adj_list[x]; current != NULL; current = current->next) {
+            if (current->vertex != x) {
+                ends[count++] = current->vertex;
+            }
+        }
+
+        removeVertex(result, x);
+        if (!hasEdge(result, ends[0], ends[1]) && addEdge(result, ends[0], ends[1]) < 0) {
+            goto error;
+        }
+
+        start = x;
+        if (ends[0] < start) {
+            start = ends[0];
+        }
+        if (ends[1] < start) {
+            start = ends[1];
+        }
+    }
+
+    return (PyObject*)result;
+
+error:
+    Py_DECREF(result);
+    return NULL;
+}
+
+static PyObject* square(AdjacencyList* self) {
+    AdjacencyList* result = (AdjacencyList*)emptyGraph(Py_TYPE(self));
+    if (result == NULL) {
+        return NULL;
+    }
+
+    // marked[u] == v + 1 <=> u jest w odlegoci 1 lub 2 od v
+    int* marked = (int*)calloc((size_t)self->capacity + 1, sizeof(int));
+    if (marked == NULL) {
+        Py_DECREF(result);
+        return PyErr_NoMemory();
+    }
+
+    for (int v = 0; v < self->capacity; v++) {
+        if (self->adj_list[v] == NULL) {
+            continue;
+        }
+        if (insertVertex(result, v) < 0) {
+            goto error;
+        }
+
+        marked[v] = v + 1;
+        for (Node* a = self->adj_list[v]; a != NULL; a = a->next) {
+            for (Node* b = self->adj_list[a->vertex]; b != NULL; b = b->next) {
+                int u = b->vertex;
+                if (u < v && marked[u] != v + 1) {
+                    marked[u] = v + 1;
+                    if (addEdge(result, u, v) < 0) {
+                        goto error;
+                    }
+                }
+            }
+        }
+    }
+
+    free(marked);
+    return (PyObject*)result;
+
+error:
+    free(marked);
+    Py_DECREF(result);
+    return NULL;
+}
+
+// Zapisuje graf w formacie g6 do out (g6Length(n) znakw, n to liczba wierzchokw).
+// Wierzchoki s numerowane kolejno od 0 tak jak w freeze. Zwraca -1, gdy brakuje pamici.
+static int adjacencyListWriteG6(AdjacencyList* self, char* out, int n) {
+    int* label = (int*)malloc(((size_t)self->capacity + 1) * sizeof(int));
+    if (label == NULL) {
+        return -1;
+    }
+
+    int next = 0;
+    for (int v = 0; v < self->capacity; v++) {
+        label[v] = self->adj_list[v] != NULL ? next++ : -1;
+    }
+
+    char* body = g6Begin(out, n);
+    for (int v = 0; v < self->capacity; v++) {
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            if (current->vertex != v && label[current->vertex] < label[v]) {
+                g6SetEdge(body, label[current->vertex], label[v]);
+            }
+        }
+    }
+    g6Finish(body, n);
+
+    free(label);
+    return 0;
+}
+
+static PyObject* to_g6(AdjacencyList* self) {
+    int n = adjacencyListOrder(self);
+    PyObject* text = PyUnicode_New(g6Length(n), 127);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    if (adjacencyListWriteG6(self, (char*)PyUnicode_1BYTE_DATA(text), n) < 0) {
+        Py_DECREF(text);
+        return PyErr_NoMemory();
+    }
+    return text;
+}
+
+static PyObject* canonical_g6(AdjacencyList* self) {
+    return canonicalText(to_g6(self));
+}
+
+// Zapisuje graf w formacie sparse6 z numeracj wierzchokw jak w to_g6. Dla kadego
+// wierzchoka v zbieramy i sortujemy jego mniejszych ssiadw, bo sparse6 wymaga krawdzi
+// uporzdkowanych wedug wikszego koca.
+static PyObject* to_sparse6(AdjacencyList* self) {
+    int* label = (int*)malloc(((size_t)self->capacity + 1) * sizeof(int));
+    int32_t* lower = (int32_t*)malloc(((size_t)self->capacity + 1) * sizeof(int32_t));
+    if (label == NULL || lower == NULL) {
+        free(label);
+        free(lower);
+        return PyErr_NoMemory();
+    }
+
+    int n = 0;
+    long long edges = 0;
+    for (int v = 0; v < self->capacity; v++) {
+        label[v] = self->adj_list[v] != NULL ? n++ : -1;
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            edges += current->vertex < v;
+        }
+    }
+
+    PyObject* text = PyUnicode_New(sparse6Bound(n, edges), 127);
+    if (text == NULL) {
+        goto done;
+    }
+
+    char* out = (char*)PyUnicode_1BYTE_DATA(text);
+    Sparse6Writer writer;
+    sparse6Begin(&writer, out, n);
+
+    for (int v = 0; v < self->capacity; v++) {
+        int count = 0;
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            if (current->vertex < v) {
+                lower[count++] = label[current->vertex];
+            }
+        }
+        qsort(lower, (size_t)count, sizeof(int32_t), compareInt32);
+        for (int i = 0; i < count; i++) {
+            sparse6Edge(&writer, lower[i], label[v]);
+        }
+    }
+
+    if (PyUnicode_Resize(&text, sparse6End(&writer, out)) < 0) {
+        text = NULL;
+    }
+
+done:
+    free(label);
+    free(lower);
+    return text;
+}
+
+static PyObject* freeze(AdjacencyList* self);
+
+// Grafy s rwne, gdy maj te same wierzchoki i te same krawdzie (z etykietami).
+// Liczniki i skrty pozwalaj zwykle odrzuci rne grafy w O(1); w przeciwnym razie
+// listy porwnywane s w O(n + m) przy uyciu tablicy znacznikw.
+static int adjacencyListEqual(AdjacencyList* a, AdjacencyList* b) {
+    if (a == b) {
+        return 1;
+    }
+    if (a->num_vertices != b->num_vertices || a->num_edges != b->num_edges || a->hash != b->hash) {
+        return 0;
+    }
+
+    int capacity = a->capacity > b->capacity ? a->capacity : b->capacity;
+    int* mark = (int*)calloc((size_t)capacity + 1, sizeof(int));
+    if (mark == NULL) {
+        PyErr_NoMemory();
+        return -1;
+    }
+
+    int equal = 1;
+    for (int v = 0; v < capacity && equal; v++) {
+        Node* first = adjacency(a, v);
+        Node* second = adjacency(b, v);
+        if ((first == NULL) != (second == NULL)) {
+            equal = 0;
+            break;
+        }
+        if (first == NULL) {
+            continue;
+        }
+        if (a->degree[v] != b->degree[v]) {
+            equal = 0;
+            break;
+        }
+
+        // Wartownik (vertex == v) nie jest krawdzi
+        for (Node* current = second; current != NULL; current = current->next) {
+            if (current->vertex != v) {
+                mark[current->vertex] = v + 1;
+            }
+        }
+        for (Node* current = first; current != NULL; current = current->next) {
+            if (current->vertex != v && mark[current->vertex] != v + 1) {
+                equal = 0;
+                break;
+            }
+        }
+    }
+
+    free(mark);
+    return equal;
+}
+
+static PyObject* AdjacencyList_richcompare(PyObject* self, PyObject* other, int op) {
+    if ((op != Py_EQ && op != Py_NE) || !PyObject_TypeCheck(self, &AdjacencyListType) ||
+        !PyObject_TypeCheck(other, &AdjacencyListType)) {
+        Py_RETURN_NOTIMPLEMENTED;
+    }
+
+    int equal = adjacencyListEqual((AdjacencyList*)self, (AdjacencyList*)other);
+    if (equal < 0) {
+        return NULL;
+    }
+    return PyBool_FromLong(op == Py_EQ ? equal : !equal);
+}
+
+// Skrt Zobrista utrzymywany przez operacje modyfikujce, wic hash(graf) kosztuje O(1).
+// Graf pozostaje modyfikowalny: po zmianie jako klucz sownika trafi pod inny skrt.
+static Py_hash_t AdjacencyList_hash(AdjacencyList* self) {
+    Py_hash_t hash = (Py_hash_t)self->hash;
+    return hash == -1 ? -2 : hash;
+}
+
+static PyMethodDef AdjacencyList_methods[] = {
+    {"number_of_vertices", (PyCFunction)number_of_vertices, METH_NOARGS},
+    {"vertices", (PyCFunction)vertices, METH_NOARGS},
+    {"vertex_degree", (PyCFunction)(void(*)(void))vertex_degree, METH_FASTCALL},
+    {"vertex_neighbors", (PyCFunction)(void(*)(void))vertex_neighbors, METH_FASTCALL},
+    {"add_vertex", (PyCFunction)(void(*)(void))add_vertex, METH_FASTCALL},
+    {"delete_vertex", (PyCFunction)(void(*)(void))delete_vertex, METH_FASTCALL},
+    {"number_of_edges", (PyCFunction)number_of_edges, METH_NOARGS},
+    {"edges", (PyCFunction)edges, METH_NOARGS},
+    {"iter_neighbors", (PyCFunction)(void(*)(void))iter_neighbors, METH_FASTCALL},
+    {"iter_edges", (PyCFunction)iter_edges, METH_NOARGS},
+    {"is_edge", (PyCFunction)(void(*)(void))is_edge, METH_FASTCALL},
+    {"adjacency_csr", (PyCFunction)adjacency_csr, METH_NOARGS},
+    {"edge_array", (PyCFunction)edge_array, METH_NOARGS},
+    {"add_edge", (PyCFunction)(void(*)(void))add_edge, METH_FASTCALL},
+    {"delete_edge", (PyCFunction)(void(*)(void))delete_edge, METH_FASTCALL},
+    {"add_edges", (PyCFunction)add_edges, METH_O},
+    {"delete_edges", (PyCFunction)delete_edges, METH_O},
+    {"is_bipartite", (PyCFunction)is_bipartite, METH_NOARGS},
+    {"complement", (PyCFunction)complement, METH_NOARGS},
+    {"connected_components", (PyCFunction)connected_components, METH_NOARGS},
+    {"create_complete_bipartite", (PyCFunction)create_complete_bipartite, METH_VARARGS | METH_CLASS},
+    {"create_cycle", (PyCFunction)create_cycle, METH_VARARGS | METH_CLASS},
+    {"create_gnm", (PyCFunction)(void(*)(void))create_gnm, METH_VARARGS | METH_KEYWORDS | METH_CLASS},
+    {"create_gnp", (PyCFunction)(void(*)(void))create_gnp, METH_VARARGS | METH_KEYWORDS | METH_CLASS},
+    {"create_path", (PyCFunction)create_path, METH_VARARGS | METH_CLASS},
+    {"create_random_regular", (PyCFunction)(void(*)(void))create_random_regular, METH_VARARGS | METH_KEYWORDS | METH_CLASS},
+    {"create_star", (PyCFunction)create_star, METH_VARARGS | METH_CLASS},
+    {"create_wheel", (PyCFunction)create_wheel, METH_VARARGS | METH_CLASS},
+    {"degree_sequence", (PyCFunction)degree_sequence, METH_NOARGS},
+    {"edge_contraction", (PyCFunction)(void(*)(void))edge_contraction, METH_FASTCALL},
+    {"induced_subgraph", (PyCFunction)induced_subgraph, METH_O},
+    {"is_complete_bipartite", (PyCFunction)is_complete_bipartite, METH_NOARGS},
+    {"is_tree", (PyCFunction)is_tree, METH_NOARGS},
+    {"distance_matrix", (PyCFunction)(void(*)(void))distance_matrix, METH_VARARGS | METH_KEYWORDS},
+    {"eccentricities", (PyCFunction)(void(*)(void))eccentricities, METH_VARARGS | METH_KEYWORDS},
+    {"diameter", (PyCFunction)(void(*)(void))diameter, METH_VARARGS | METH_KEYWORDS},
+    {"wiener_index", (PyCFunction)(void(*)(void))wiener_index, METH_VARARGS | METH_KEYWORDS},
+    {"number_of_triangles", (PyCFunction)number_of_triangles, METH_NOARGS},
+    {"smoothing", (PyCFunction)smoothing, METH_NOARGS},
+    {"square", (PyCFunction)square, METH_NOARGS},
+    {"to_g6", (PyCFunction)to_g6, METH_NOARGS},
+    {"canonical_g6", (PyCFunction)canonical_g6, METH_NOARGS},
+    {"to_sparse6", (PyCFunction)to_sparse6, METH_NOARGS},
+    {"freeze", (PyCFunction)freeze, METH_NOARGS},
+    {NULL, NULL}
+};
+
+static PyTypeObject AdjacencyListType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "simple_graphs.AdjacencyList",    /* tp_name */
+    sizeof(AdjacencyList),             /* tp_basicsize */
+    0,                                 /* tp_name */
+    (destructor)AdjacencyList_dealloc, /* tp_dealloc */
+    0,                                 /* tp_vectorcall_offset */
+    0,                                 /* tp_getattr */
+    0,                                 /* tp_setattr */
+    0,                                 /* tp_as_async */
+    0,                                 /* tp_repr */
+    0,                                 /* tp_as_number */
+    0,                                 /* tp_as_sequence */
+    0,                                 /* tp_as_mapping */
+    (hashfunc)AdjacencyList_hash,      /* tp_hash */
+    0,                                 /* tp_call */
+    0,                                 /* tp_str */
+    0,                                 /* tp_getattro */
+    0,                                 /* tp_setattro */
+    0,                                 /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                /* tp_flags */
+    0,                                 /* tp_doc */
+    0,                                 /* tp_traverse */
+    0,                                 /* tp_clear */
+    AdjacencyList_richcompare,         /* tp_richcompare */
+    0,                                 /* tp_weaklistoffset */
+    0,                                 /* tp_iter */
+    0,                                 /* tp_iternext */
+    AdjacencyList_methods,             /* tp_methods */
+    0,                                 /* tp_members */
+    0,                                 /* tp_getset */
+    0,                                 /* tp_base */
+    0,                                 /* tp_dict */
+    0,                                 /* tp_descr_get */
+    0,                                 /* tp_descr_set */
+    0,                                 /* tp_dictoffset */
+    (initproc)AdjacencyList_init,      /* tp_init */
+    0,                                 /* tp_alloc */
+    AdjacencyList_new,                 /* tp_new */
+};
+
+// Macierz ssiedztwa dla grafw o co najwyej 64 wierzchokach. Kady wiersz to maska bitowa,
+// wic is_edge jest O(1), a stopie wierzchoka to jedna instrukcja popcount.
+#define MATRIX_MAX_VERTICES 64
+
+typedef struct
+{
+    PyObject_HEAD
+    uint64_t vertices;                   // maska istniejcych wierzchokw
+    uint64_t rows[MATRIX_MAX_VERTICES];  // bit v w rows[u] <=> krawd {u, v}
+} AdjacencyMatrix;
+
+static PyObject* AdjacencyMatrix_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    AdjacencyMatrix* self;
+    self = (AdjacencyMatrix*)type->tp_alloc(type, 0);
+    if (self != NULL) {
+        self->vertices = 0;
+        memset(self->rows, 0, sizeof(self->rows));
+    }
+    return (PyObject*)self;
+}
+
+static int adjacencyMatrixLoadSparse6(AdjacencyMatrix* self, const char* text, Py_ssize_t length) {
+    Sparse6Reader reader;
+    int u, v, result;
+
+    if (sparse6Header(&reader, text, length) < 0) {
+        return -1;
+    }
+    if (reader.n > MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Macierz ssiedztwa obsuguje co najwyej 64 wierzchoki");
+        return -1;
+    }
+
+    self->vertices = reader.n == 64 ? ~(uint64_t)0 : (((uint64_t)1 << reader.n) - 1);
+    while ((result = sparse6Next(&reader, &u, &v)) > 0) {
+        if (u != v) {
+            self->rows[u] |= (uint64_t)1 << v;
+            self->rows[v] |= (uint64_t)1 << u;
+        }
+    }
+
+    if (result < 0) {
+        sparse6CharacterError();
+        return -1;
+    }
+    return 0;
+}
+
+// Wczytuje graf z formatu g6 albo sparse6 (tekst zaczynajcy si od ':').
+static int adjacencyMatrixLoadG6(AdjacencyMatrix* self, const char* text, Py_ssize_t length) {
+    self->vertices = 0;
+    memset(self->rows, 0, sizeof(self->rows));
+
+    if (rejectDigraph6(text, length) < 0) {
+        return -1;
+    }
+    if (length > 0 && text[0] == ':') {
+        return adjacencyMatrixLoadSparse6(self, text, length);
+    }
+
+    if (length > 0 && text[0] != '?') {
+        int num_vertices;
+        const char* body = g6Header(text, length, &num_vertices);
+
+        if (body == NULL) {
+            return -1;
+        }
+        if (num_vertices > MATRIX_MAX_VERTICES) {
+            PyErr_SetString(PyExc_ValueError, "Macierz ssiedztwa obsuguje co najwyej 64 wierzchoki");
+            return -1;
+        }
+
+        self->vertices = num_vertices == 64 ? ~(uint64_t)0 : (((uint64_t)1 << num_vertices) - 1);
+
+        int c = 0;
+        int i = 0;
+        int k = 0;
+
+        for (int v = 1; v < num_vertices; v++) {
+            for (int u = 0; u < v; u++) {
+                if (k == 0) {
+                    c = body[i++] - 63;
+                    k = 6;
+                }
+                k--;
+
+                if ((c & (1 << k)) != 0) {
+                    self->rows[u] |= (uint64_t)1 << v;
+                    self->rows[v] |= (uint64_t)1 << u;
+                }
+            }
+        }
+    }
+
+    return 0;
+}
+
+static int AdjacencyMatrix_init(AdjacencyMatrix* self, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "text", NULL };
+    char* text = "?";
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", kwlist, &text)) {
+        return -1;
+    }
+
+    return adjacencyMatrixLoadG6(self, text, (Py_ssize_t)strlen(text));
+}
+
+static PyObject* AdjacencyMatrix_number_of_vertices(AdjacencyMatrix* self) {
+    return PyLong_FromLong(POPCOUNT64(self->vertices));
+}
+
+// Tworzy zbir Pythona z numerw bitw ustawionych w masce.
+static PyObject* maskToSet(uint64_t mask) {
+    PyObject* result = PySet_New(NULL);
+
+    if (result == NULL) {
+        return NULL;
+    }
+
+    while (mask != 0) {
+        PyObject* vertex = PyLong_FromLong(CTZ64(mask));
+
+        if (vertex == NULL || PySet_Add(result, vertex) < 0) {
+            Py_XDECREF(vertex);
+            Py_DECREF(result);
+            return NULL;
+        }
+        Py_DECREF(vertex);
+        mask &= mask - 1;
+    }
+
+    return result;
+}
+
+static PyObject* AdjacencyMatrix_vertices(AdjacencyMatrix* self) {
+    return maskToSet(self->vertices);
+}
+
+static PyObject* AdjacencyMatrix_vertex_degree(AdjacencyMatrix* self, PyObject* args) {
+    int vertex;
+
+    if (!PyArg_ParseTuple(args, "i", &vertex)) {
+        return NULL;
+    }
+
+    if (vertex < 0 || vertex >= MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    return PyLong_FromLong(POPCOUNT64(self->rows[vertex]));
+}
+
+static PyObject* AdjacencyMatrix_vertex_neighbors(AdjacencyMatrix* self, PyObject* args) {
+    int vertex;
+
+    if (!PyArg_ParseTuple(args, "i", &vertex)) {
+        return NULL;
+    }
+
+    if (vertex < 0 || vertex >= MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    return maskToSet(self->rows[vertex]);
+}
+
+static PyObject* AdjacencyMatrix_add_vertex(AdjacencyMatrix* self, PyObject* args) {
+    int vertex;
+
+    if (!PyArg_ParseTuple(args, "i", &vertex)) {
+        return NULL;
+    }
+
+    if (vertex < 0 || vertex >= MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    if (self->vertices & ((uint64_t)1 << vertex)) {
+        PyErr_SetString(PyExc_ValueError, "Wierzchoek ju istnieje w grafie");
+        return NULL;
+    }
+
+    self->vertices |= (uint64_t)1 << vertex;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* AdjacencyMatrix_delete_vertex(AdjacencyMatrix* self, PyObject* args) {
+    int vertex;
+
+    if (!PyArg_ParseTuple(args, "i", &vertex)) {
+        return NULL;
+    }
+
+    if (vertex < 0 || vertex >= MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    uint64_t bit = (uint64_t)1 << vertex;
+
+    if ((self->vertices & bit) == 0) {
+        PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje");
+        return NULL;
+    }
+
+    // Usuwamy wierzchoek z wierszy wszystkich jego ssiadw
+    uint64_t neighbors = self->rows[vertex];
+    while (neighbors != 0) {
+        self->rows[CTZ64(neighbors)] &= ~bit;
+        neighbors &= neighbors - 1;
+    }
+    self->rows[vertex] = 0;
+    self->vertices &= ~bit;
+
+    Py_RETURN_NONE;
+}
+
+static PyObject* AdjacencyMatrix_number_of_edges(AdjacencyMatrix* self) {
+    int degreeSum = 0;
+    int loops = 0;
+
+    for (int i = 0; i < MATRIX_MAX_VERTICES; i++) {
+        degreeSum += POPCOUNT64(self->rows[i]);
+        loops += (int)((self->rows[i] >> i) & 1);
+    }
+
+    return PyLong_FromLong((degreeSum + loops) / 2);
+}
+
+static PyObject* AdjacencyMatrix_edges(AdjacencyMatrix* self) {
+    PyObject* edges_set = PySet_New(NULL);
+
+    if (edges_set == NULL) {
+        PyErr_SetString(PyExc_RuntimeError, "Nie mona zaalokowa pamici dla zbioru (set)");
+        return NULL;
+    }
+
+    for (int u = 0; u < MATRIX_MAX_VERTICES; u++) {
+        // Tylko ssiedzi v >= u, eby kad krawd zwrci raz
+        uint64_t higher = self->rows[u] & (~(uint64_t)0 << u);
+
+        while (higher != 0) {
+            PyObject* edge_tuple = Py_BuildValue("(ii)", u, CTZ64(higher));
+            if (edge_tuple == NULL) {
+                Py_DECREF(edges_set);
+                PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia krotki (tuple)");
+                return NULL;
+            }
+
+            int result = PySet_Add(edges_set, edge_tuple);
+            Py_DECREF(edge_tuple);
+
+            if (result < 0) {
+                Py_DECREF(edges_set);
+                PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas dodawania krotki do zbioru");
+                return NULL;
+            }
+            higher &= higher - 1;
+        }
+    }
+
+    return edges_set;
+}
+
+static PyObject* AdjacencyMatrix_is_edge(AdjacencyMatrix* self, PyObject* args) {
+    int u, v;
+
+    if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
+        return NULL;
+    }
+
+    if (u < 0 || u >= MATRIX_MAX_VERTICES || v < 0 || v >= MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    return PyBool_FromLong((long)((self->rows[u] >> v) & 1));
+}
+
+static PyObject* AdjacencyMatrix_add_edge(AdjacencyMatrix* self, PyObject* args) {
+    int u, v;
+
+    if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
+        return NULL;
+    }
+
+    if (u < 0 || u >= MATRIX_MAX_VERTICES || v < 0 || v >= MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    // Brakujce koce s dodawane jako wierzchoki (jak w AdjacencyList), a ptle pomijane
+    self->vertices |= (uint64_t)1 << u | (uint64_t)1 << v;
+    if (u != v) {
+        self->rows[u] |= (uint64_t)1 << v;
+        self->rows[v] |= (uint64_t)1 << u;
+    }
+
+    return PyBool_FromLong(1);
+}
+
+static PyObject* AdjacencyMatrix_delete_edge(AdjacencyMatrix* self, PyObject* args) {
+    int u, v;
+
+    if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
+        return NULL;
+    }
+
+    if (u < 0 || u >= MATRIX_MAX_VERTICES || v < 0 || v >= MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    if ((self->vertices & ((uint64_t)1 << u)) == 0 || (self->vertices & ((uint64_t)1 << v)) == 0) {
+        PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje w grafie");
+        return NULL;
+    }
+
+    // Jak w AdjacencyList: usunicie nieistniejcej krawdzi (take ptli) jest bdem
+    if ((self->rows[u] & ((uint64_t)1 << v)) == 0) {
+        PyErr_SetString(PyExc_ValueError, "Krawd nie istnieje w grafie");
+        return NULL;
+    }
+
+    self->rows[u] &= ~((uint64_t)1 << v);
+    self->rows[v] &= ~((uint64_t)1 << u);
+
+    return PyBool_FromLong(1);
+}
+
+// Wersje add_edges/delete_edges dla macierzy, o tej samej semantyce co w AdjacencyList:
+// indeksy sprawdzane s przed jakkolwiek zmian, brakujce koce dodawanych krawdzi staj
+// si wierzchokami, a ptle s pomijane; delete_edges odrzuca cae wywoanie, jeli ktra
+// krawd nie istnieje. Zwracaj liczb dodanych albo usunitych krawdzi.
+static PyObject* AdjacencyMatrix_add_edges(AdjacencyMatrix* self, PyObject* edges) {
+    int* pairs;
+    Py_ssize_t count = readEdgePairs(edges, MATRIX_MAX_VERTICES, &pairs);
+    if (count < 0) {
+        return NULL;
+    }
+
+    long long added = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int u = pairs[2 * i];
+        int v = pairs[2 * i + 1];
+        self->vertices |= (uint64_t)1 << u | (uint64_t)1 << v;
+        if (u != v && (self->rows[u] & ((uint64_t)1 << v)) == 0) {
+            self->rows[u] |= (uint64_t)1 << v;
+            self->rows[v] |= (uint64_t)1 << u;
+            added++;
+        }
+    }
+
+    free(pairs);
+    return PyLong_FromLongLong(added);
+}
+
+static PyObject* AdjacencyMatrix_delete_edges(AdjacencyMatrix* self, PyObject* edges) {
+    int* pairs;
+    Py_ssize_t count = readEdgePairs(edges, MATRIX_MAX_VERTICES, &pairs);
+    if (count < 0) {
+        return NULL;
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int u = pairs[2 * i];
+        int v = pairs[2 * i + 1];
+        if ((self->vertices & ((uint64_t)1 << u)) == 0 || (self->vertices & ((uint64_t)1 << v)) == 0) {
+            free(pairs);
+            PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje w grafie");
+            return NULL;
+        }
+        if ((self->rows[u] & ((uint64_t)1 << v)) == 0) {
+            free(pairs);
+            PyErr_SetString(PyExc_ValueError, "Krawd nie istnieje w grafie");
+            return NULL;
+        }
+    }
+
+    // Powtrzenia tej samej krawdzi s pomijane
+    long long deleted = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        int u = pairs[2 * i];
+        int v = pairs[2 * i + 1];
+        if ((self->rows[u] & ((uint64_t)1 << v)) != 0) {
+            self->rows[u] &= ~((uint64_t)1 << v);
+            self->rows[v] &= ~((uint64_t)1 << u);
+            deleted++;
+        }
+    }
+
+    free(pairs);
+    return PyLong_FromLongLong(deleted);
+}
+
+static PyObject* AdjacencyMatrix_is_bipartite(AdjacencyMatrix* self) {
+    uint64_t remaining = self->vertices;
+
+    // BFS po maskach: caa warstwa przetwarzana jest naraz, a kolory
+    // przypisujemy caym warstwom na przemian
+    while (remaining != 0) {
+        uint64_t frontier = remaining & (~remaining + 1);
+        uint64_t colors[2] = { 0, 0 };
+        int color = 0;
+
+        while (frontier != 0) {
+            colors[color] |= frontier;
+            remaining &= ~frontier;
+
+            uint64_t next = 0;
+            uint64_t layer = frontier;
+            while (layer != 0) {
+                next |= self->rows[CTZ64(layer)];
+                layer &= layer - 1;
+            }
+            frontier = next & remaining;
+            color = 1 - color;
+        }
+
+        // Krawd wewntrz jednej klasy koloru oznacza cykl nieparzysty
+        for (int c = 0; c < 2; c++) {
+            uint64_t members = colors[c];
+            while (members != 0) {
+                if (self->rows[CTZ64(members)] & colors[c]) {
+                    Py_RETURN_FALSE;
+                }
+                members &= members - 1;
+            }
+        }
+    }
+
+    Py_RETURN_TRUE;
+}
+
+static PyObject* AdjacencyMatrix_edge_array(AdjacencyMatrix* self) {
+    Py_ssize_t count = 0;
+    for (int u = 0; u < MATRIX_MAX_VERTICES; u++) {
+        count += POPCOUNT64(self->rows[u] & (~(uint64_t)0 << u));
+    }
+
+    PyObject* bytes = PyBytes_FromStringAndSize(NULL, 2 * count * (Py_ssize_t)sizeof(int32_t));
+    if (bytes == NULL) {
+        return NULL;
+    }
+    int32_t* pairs = (int32_t*)PyBytes_AS_STRING(bytes);
+
+    for (int u = 0; u < MATRIX_MAX_VERTICES; u++) {
+        uint64_t higher = self->rows[u] & (~(uint64_t)0 << u);
+        while (higher != 0) {
+            *pairs++ = u;
+            *pairs++ = CTZ64(higher);
+            higher &= higher - 1;
+        }
+    }
+
+    return bytesView(bytes, "i");
+}
+
+// Udostpnia wiersze macierzy bez kopiowania jako bufor tylko do odczytu:
+// 64 liczby uint64 (format 'Q'), bit v w wierszu u oznacza krawd {u, v}.
+static int AdjacencyMatrix_getbuffer(AdjacencyMatrix* self, Py_buffer* view, int flags) {
+    static Py_ssize_t shape[1] = { MATRIX_MAX_VERTICES };
+    static Py_ssize_t strides[1] = { sizeof(uint64_t) };
+
+    if ((flags & PyBUF_WRITABLE) == PyBUF_WRITABLE) {
+        PyErr_SetString(PyExc_BufferError, "Macierz ssiedztwa jest udostpniana tylko do odczytu");
+        view->obj = NULL;
+        return -1;
+    }
+
+    view->obj = (PyObject*)self;
+    Py_INCREF(self);
+    view->buf = self->rows;
+    view->len = sizeof(self->rows);
+    view->readonly = 1;
+    view->itemsize = sizeof(uint64_t);
+    view->format = (flags & PyBUF_FORMAT) == PyBUF_FORMAT ? "Q" : NULL;
+    view->ndim = 1;
+    view->shape = (flags & PyBUF_ND) == PyBUF_ND ? shape : NULL;
+    view->strides = (flags & PyBUF_STRIDES) == PyBUF_STRIDES ? strides : NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    return 0;
+}
+
+static PyBufferProcs AdjacencyMatrix_as_buffer = {
+    (getbufferproc)AdjacencyMatrix_getbuffer,
+    NULL
+};
+
+static PyObject* AdjacencyMatrix_number_of_triangles(AdjacencyMatrix* self) {
+    uint64_t rows[MATRIX_MAX_VERTICES];
+
+    // Ptle nie tworz trjktw, wic usuwamy je z kopii wierszy
+    for (int i = 0; i < MATRIX_MAX_VERTICES; i++) {
+        rows[i] = self->rows[i] & ~((uint64_t)1 << i);
+    }
+
+    return PyLong_FromLongLong(countTriangles(rows, MATRIX_MAX_VERTICES, 1));
+}
+
+static void adjacencyMatrixWriteG6(AdjacencyMatrix* self, char* out) {
+    int n = POPCOUNT64(self->vertices);
+    char* body = g6Begin(out, n);
+
+    // Numer wierzchoka w zapisie g6 to liczba istniejcych wierzchokw o mniejszym indeksie
+    int label = 0;
+    for (uint64_t remaining = self->vertices; remaining != 0; remaining &= remaining - 1, label++) {
+        int v = CTZ64(remaining);
+        uint64_t lower = self->rows[v] & self->vertices & (((uint64_t)1 << v) - 1);
+        for (; lower != 0; lower &= lower - 1) {
+            uint64_t below = ((uint64_t)1 << CTZ64(lower)) - 1;
+            g6SetEdge(body, POPCOUNT64(self->vertices & below), label);
+        }
+    }
+    g6Finish(body, n);
+}
+
+static PyObject* AdjacencyMatrix_to_sparse6(AdjacencyMatrix* self) {
+    int n = POPCOUNT64(self->vertices);
+    long long edges = 0;
+    for (uint64_t remaining = self->vertices; remaining != 0; remaining &= remaining - 1) {
+        int v = CTZ64(remaining);
+        edges += POPCOUNT64(self->rows[v] & self->vertices & (((uint64_t)1 << v) - 1));
+    }
+
+    PyObject* text = PyUnicode_New(sparse6Bound(n, edges), 127);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    char* out = (char*)PyUnicode_1BYTE_DATA(text);
+    Sparse6Writer writer;
+    sparse6Begin(&writer, out, n);
+
+    int label = 0;
+    for (uint64_t remaining = self->vertices; remaining != 0; remaining &= remaining - 1, label++) {
+        int v = CTZ64(remaining);
+        uint64_t lower = self->rows[v] & self->vertices & (((uint64_t)1 << v) - 1);
+        for (; lower != 0; lower &= lower - 1) {
+            uint64_t below = ((uint64_t)1 << CTZ64(lower)) - 1;
+            sparse6Edge(&writer, POPCOUNT64(self->vertices & below), label);
+        }
+    }
+
+    if (PyUnicode_Resize(&text, sparse6End(&writer, out)) < 0) {
+        return NULL;
+    }
+    return text;
+}
+
+static PyObject* AdjacencyMatrix_to_g6(AdjacencyMatrix* self) {
+    PyObject* text = PyUnicode_New(g6Length(POPCOUNT64(self->vertices)), 127);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    adjacencyMatrixWriteG6(self, (char*)PyUnicode_1BYTE_DATA(text));
+    return text;
+}
+
+static PyObject* AdjacencyMatrix_canonical_g6(AdjacencyMatrix* self) {
+    return canonicalText(AdjacencyMatrix_to_g6(self));
+}
+
+// Tworzy macierz o wierzchokach 0..n-1 bez krawdzi.
+static AdjacencyMatrix* matrixWithVertices(PyTypeObject* type, int n) {
+    if (n < 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return NULL;
+    }
+    if (n > MATRIX_MAX_VERTICES) {
+        PyErr_SetString(PyExc_ValueError, "Macierz ssiedztwa obsuguje co najwyej 64 wierzchoki");
+        return NULL;
+    }
+
+    AdjacencyMatrix* result = (AdjacencyMatrix*)emptyGraph(type);
+    if (result != NULL) {
+        result->vertices = n == MATRIX_MAX_VERTICES ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+    }
+    return result;
+}
+
+// Dodaje krawd {u, v}, o ile nie jest ptl.
+static void matrixAddEdge(AdjacencyMatrix* self, int u, int v) {
+    if (u != v) {
+        self->rows[u] |= (uint64_t)1 << v;
+        self->rows[v] |= (uint64_t)1 << u;
+    }
+}
+
+static PyObject* AdjacencyMatrix_create_complete_bipartite(PyTypeObject* type, PyObject* args) {
+    int n, m;
+
+    if (!PyArg_ParseTuple(args, "ii", &n, &m)) {
+        return NULL;
+    }
+    if (n < 0 || m < 0) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawna liczba wierzchokw");
+        return NULL;
+    }
+
+    AdjacencyMatrix* result = matrixWithVertices(type, (long long)n + m > MATRIX_MAX_VERTICES ? MATRIX_MAX_VERTICES + 1 : n + m);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    // Pierwsze n wierzchokw ssiaduje ze wszystkimi pozostaymi
+    uint64_t first = n == MATRIX_MAX_VERTICES ? ~(uint64_t)0 : (((uint64_t)1 << n) - 1);
+    for (int v = 0; v < n + m; v++) {
+        result->rows[v] = v < n ? result->vertices & ~first : first;
+    }
+    return (PyObject*)result;
+}
+
+static PyObject* AdjacencyMatrix_create_cycle(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    AdjacencyMatrix* result = matrixWithVertices(type, n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int i = 0; i < n; i++) {
+        matrixAddEdge(result, i, (i + 1) % n);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject* AdjacencyMatrix_create_path(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    AdjacencyMatrix* result = matrixWithVertices(type, n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int i = 1; i < n; i++) {
+        matrixAddEdge(result, i - 1, i);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject* AdjacencyMatrix_create_star(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    AdjacencyMatrix* result = matrixWithVertices(type, n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    for (int i = 1; i < n; i++) {
+        matrixAddEdge(result, 0, i);
+    }
+    return (PyObject*)result;
+}
+
+static PyObject* AdjacencyMatrix_create_wheel(PyTypeObject* type, PyObject* args) {
+    int n;
+
+    if (!PyArg_ParseTuple(args, "i", &n)) {
+        return NULL;
+    }
+
+    AdjacencyMatrix* result = matrixWithVertices(type, n);
+    if (result == NULL) {
+        return NULL;
+    }
+
+    // Wierzchoki 0..n-2 tworz obrcz, a n-1 jest rodkiem koa
+    for (int i = 0; i < n - 1; i++) {
+        matrixAddEdge(result, i, n - 1);
+        matrixAddEdge(result, i, (i + 1) % (n - 1));
+    }
+    return (PyObject*)result;
+}
+
+static PyObject* randomAdjacencyMatrix(PyTypeObject* type, PyObject* args, PyObject* kwds, int model) {
+    int n;
+    int* pairs;
+    long long count = randomGraphPairs(model, args, kwds, MATRIX_MAX_VERTICES, &n, &pairs);
+    if (count < 0) {
+        return NULL;
+    }
+
+    AdjacencyMatrix* result = matrixWithVertices(type, n);
+    for (long long i = 0; result != NULL && i < count; i++) {
+        matrixAddEdge(result, pairs[2 * i], pairs[2 * i + 1]);
+    }
+
+    free(pairs);
+    return (PyObject*)result;
+}
+
+static PyObject* AdjacencyMatrix_create_gnp(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    return randomAdjacencyMatrix(type, args, kwds, RANDOM_GNP);
+}
+
+static PyObject* AdjacencyMatrix_create_gnm(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    return randomAdjacencyMatrix(type, args, kwds, RANDOM_GNM);
+}
+
+static PyObject* AdjacencyMatrix_create_random_regular(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    return randomAdjacencyMatrix(type, args, kwds, RANDOM_REGULAR);
+}
+
+// Zapytania o odlegoci na tablicach CSR; wierzchoki numerujemy kolejno od 0.
+static PyObject* adjacencyMatrixDistances(AdjacencyMatrix* self, PyObject* args, PyObject* kwds, int query) {
+    int threads = parseThreads(args, kwds);
+    if (threads < 0) {
+        return NULL;
+    }
+
+    int64_t offsets[MATRIX_MAX_VERTICES + 1];
+    int32_t targets[MATRIX_MAX_VERTICES * MATRIX_MAX_VERTICES];
+    int n = 0;
+    offsets[0] = 0;
+    for (uint64_t vertices = self->vertices; vertices != 0; vertices &= vertices - 1) {
+        int v = CTZ64(vertices);
+        int64_t position = offsets[n];
+        for (uint64_t row = self->rows[v]; row != 0; row &= row - 1) {
+            uint64_t below = ((uint64_t)1 << CTZ64(row)) - 1;
+            targets[position++] = POPCOUNT64(self->vertices & below);
+        }
+        offsets[++n] = position;
+    }
+
+    return distanceQuery(n, offsets, targets, query, threads);
+}
+
+static PyObject* AdjacencyMatrix_distance_matrix(AdjacencyMatrix* self, PyObject* args, PyObject* kwds) {
+    return adjacencyMatrixDistances(self, args, kwds, DISTANCE_MATRIX);
+}
+
+static PyObject* AdjacencyMatrix_eccentricities(AdjacencyMatrix* self, PyObject* args, PyObject* kwds) {
+    return adjacencyMatrixDistances(self, args, kwds, DISTANCE_ECCENTRICITIES);
+}
+
+static PyObject* AdjacencyMatrix_diameter(AdjacencyMatrix* self, PyObject* args, PyObject* kwds) {
+    return adjacencyMatrixDistances(self, args, kwds, DISTANCE_DIAMETER);
+}
+
+static PyObject* AdjacencyMatrix_wiener_index(AdjacencyMatrix* self, PyObject* args, PyObject* kwds) {
+    return adjacencyMatrixDistances(self, args, kwds, DISTANCE_WIENER_INDEX);
+}
+
+static PyMethodDef AdjacencyMatrix_methods[] = {
+    {"number_of_vertices", (PyCFunction)AdjacencyMatrix_number_of_vertices, METH_NOARGS},
+    {"vertices", (PyCFunction)AdjacencyMatrix_vertices, METH_NOARGS},
+    {"vertex_degree", (PyCFunction)AdjacencyMatrix_vertex_degree, METH_VARARGS},
+    {"vertex_neighbors", (PyCFunction)AdjacencyMatrix_vertex_neighbors, METH_VARARGS},
+    {"add_vertex", (PyCFunction)AdjacencyMatrix_add_vertex, METH_VARARGS},
+    {"delete_vertex", (PyCFunction)AdjacencyMatrix_delete_vertex, METH_VARARGS},
+    {"number_of_edges", (PyCFunction)AdjacencyMatrix_number_of_edges, METH_NOARGS},
+    {"edges", (PyCFunction)AdjacencyMatrix_edges, METH_NOARGS},
+    {"is_edge", (PyCFunction)AdjacencyMatrix_is_edge, METH_VARARGS},
+    {"edge_array", (PyCFunction)AdjacencyMatrix_edge_array, METH_NOARGS},
+    {"add_edge", (PyCFunction)AdjacencyMatrix_add_edge, METH_VARARGS},
+    {"delete_edge", (PyCFunction)AdjacencyMatrix_delete_edge, METH_VARARGS},
+    {"add_edges", (PyCFunction)AdjacencyMatrix_add_edges, METH_O},
+    {"delete_edges", (PyCFunction)AdjacencyMatrix_delete_edges, METH_O},
+    {"is_bipartite", (PyCFunction)AdjacencyMatrix_is_bipartite, METH_NOARGS},
+    {"number_of_triangles", (PyCFunction)AdjacencyMatrix_number_of_triangles, METH_NOARGS},
+    {"distance_matrix", (PyCFunction)(void(*)(void))AdjacencyMatrix_distance_matrix, METH_VARARGS | METH_KEYWORDS},
+    {"eccentricities", (PyCFunction)(void(*)(void))AdjacencyMatrix_eccentricities, METH_VARARGS | METH_KEYWORDS},
+    {"diameter", (PyCFunction)(void(*)(void))AdjacencyMatrix_diameter, METH_VARARGS | METH_KEYWORDS},
+    {"wiener_index", (PyCFunction)(void(*)(void))AdjacencyMatrix_wiener_index, METH_VARARGS | METH_KEYWORDS},
+    {"to_g6", (PyCFunction)AdjacencyMatrix_to_g6, METH_NOARGS},
+    {"canonical_g6", (PyCFunction)AdjacencyMatrix_canonical_g6, METH_NOARGS},
+    {"to_sparse6", (PyCFunction)AdjacencyMatrix_to_sparse6, METH_NOARGS},
+    {"create_complete_bipartite", (PyCFunction)AdjacencyMatrix_create_complete_bipartite, METH_VARARGS | METH_CLASS},
+    {"create_cycle", (PyCFunction)AdjacencyMatrix_create_cycle, METH_VARARGS | METH_CLASS},
+    {"create_gnm", (PyCFunction)(void(*)(void))AdjacencyMatrix_create_gnm, METH_VARARGS | METH_KEYWORDS | METH_CLASS},
+    {"create_gnp", (PyCFunction)(void(*)(void))AdjacencyMatrix_create_gnp, METH_VARARGS | METH_KEYWORDS | METH_CLASS},
+    {"create_path", (PyCFunction)AdjacencyMatrix_create_path, METH_VARARGS | METH_CLASS},
+    {"create_random_regular", (PyCFunction)(void(*)(void))AdjacencyMatrix_create_random_regular, METH_VARARGS | METH_KEYWORDS | METH_CLASS},
+    {"create_star", (PyCFunction)AdjacencyMatrix_create_star, METH_VARARGS | METH_CLASS},
+    {"create_wheel", (PyCFunction)AdjacencyMatrix_create_wheel, METH_VARARGS | METH_CLASS},
+    {NULL, NULL}
+};
+
+static PyTypeObject AdjacencyMatrixType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "simple_graphs.AdjacencyMatrix",   /* tp_name */
+    sizeof(AdjacencyMatrix),           /* tp_basicsize */
+    0,                                 /* tp_itemsize */
+    0,                                 /* tp_dealloc */
+    0,                                 /* tp_vectorcall_offset */
+    0,                                 /* tp_getattr */
+    0,                                 /* tp_setattr */
+    0,                                 /* tp_as_async */
+    0,                                 /* tp_repr */
+    0,                                 /* tp_as_number */
+    0,                                 /* tp_as_sequence */
+    0,                                 /* tp_as_mapping */
+    0,                                 /* tp_hash */
+    0,                                 /* tp_call */
+    0,                                 /* tp_str */
+    0,                                 /* tp_getattro */
+    0,                                 /* tp_setattro */
+    &AdjacencyMatrix_as_buffer,        /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                /* tp_flags */
+    0,                                 /* tp_doc */
+    0,                                 /* tp_traverse */
+    0,                                 /* tp_clear */
+    0,                                 /* tp_richcompare */
+    0,                                 /* tp_weaklistoffset */
+    0,                                 /* tp_iter */
+    0,                                 /* tp_iternext */
+    AdjacencyMatrix_methods,           /* tp_methods */
+    0,                                 /* tp_members */
+    0,                                 /* tp_getset */
+    0,                                 /* tp_base */
+    0,                                 /* tp_dict */
+    0,                                 /* tp_descr_get */
+    0,                                 /* tp_descr_set */
+    0,                                 /* tp_dictoffset */
+    (initproc)AdjacencyMatrix_init,    /* tp_init */
+    0,                                 /* tp_alloc */
+    AdjacencyMatrix_new,               /* tp_new */
+};
+
+// Niezmienny graf w formacie CSR: ssiedzi wierzchoka v to targets[offsets[v]:offsets[v + 1]],
+// posortowani rosnco. Wierzchokami s zawsze 0..n-1. Obie tablice le jedna za drug
+// w jednym buforze (obiekt bytes), wic przegldanie grafu czyta pami sekwencyjnie.
+// Graf wczytany z digraph6 jest skierowany: wiersz v zawiera wtedy tylko nastpnikw v.
+typedef struct
+{
+    PyObject_HEAD
+    Py_buffer data;            // bufor przechowujcy offsets i targets
+    const int64_t* offsets;    // n + 1 elementw
+    const int32_t* targets;    // offsets[n] elementw
+    int n;
+    int directed;
+} CSRGraph;
+
+// Tworzy graf CSR o n wierzchokach i arcs ukach (2 * liczba krawdzi) w nowym buforze bytes.
+// Tablice s zwracane do wypenienia przez wywoujcego, zanim graf trafi do Pythona.
+static CSRGraph* csrAlloc(PyTypeObject* type, int n, int64_t arcs, int64_t** offsets, int32_t** targets) {
+    Py_ssize_t offsetsSize = ((Py_ssize_t)n + 1) * (Py_ssize_t)sizeof(int64_t);
+    PyObject* bytes = PyBytes_FromStringAndSize(NULL, offsetsSize + (Py_ssize_t)arcs * (Py_ssize_t)sizeof(int32_t));
+    if (bytes == NULL) {
+        return NULL;
+    }
+
+    CSRGraph* self = (CSRGraph*)type->tp_alloc(type, 0);
+    if (self == NULL) {
+        Py_DECREF(bytes);
+        return NULL;
+    }
+
+    int result = PyObject_GetBuffer(bytes, &self->data, PyBUF_SIMPLE);
+    Py_DECREF(bytes);
+    if (result < 0) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    *offsets = (int64_t*)self->data.buf;
+    *targets = (int32_t*)((char*)self->data.buf + offsetsSize);
+    self->offsets = *offsets;
+    self->targets = *targets;
+    self->n = n;
+    self->directed = 0;
+    return self;
+}
+
+// Buduje graf CSR bezporednio z g6 w dwch przebiegach: najpierw stopnie, potem ssiedzi.
+// Kolejno bitw g6 (kolumnami) sprawia, e kady wiersz od razu jest posortowany.
+static PyObject* csrFromG6(PyTypeObject* type, const char* text, Py_ssize_t length) {
+    int n = 0;
+    const char* body = NULL;
+
+    if (length > 0 && text[0] != '?') {
+        body = g6Header(text, length, &n);
+        if (body == NULL) {
+            return NULL;
+        }
+    }
+
+    int64_t* degree = (int64_t*)calloc((size_t)n + 1, sizeof(int64_t));
+    if (degree == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    int c = 0;
+    long long i = 0;
+    int k = 0;
+
+    for (int v = 1; v < n; v++) {
+        for (int u = 0; u < v; u++) {
+            if (k == 0) {
+                c = body[i++] - 63;
+                k = 6;
+            }
+            k--;
+
+            if ((c & (1 << k)) != 0) {
+                degree[u]++;
+                degree[v]++;
+            }
+        }
+    }
+
+    int64_t arcs = 0;
+    for (int v = 0; v < n; v++) {
+        arcs += degree[v];
+    }
+
+    int64_t* offsets;
+    int32_t* targets;
+    CSRGraph* self = csrAlloc(type, n, arcs, &offsets, &targets);
+    if (self == NULL) {
+        free(degree);
+        return NULL;
+    }
+
+    // degree[v] staje si pozycj zapisu nastpnego ssiada v
+    offsets[0] = 0;
+    for (int v = 0; v < n; v++) {
+        offsets[v + 1] = offsets[v] + degree[v];
+        degree[v] = offsets[v];
+    }
+
+    c = 0;
+    i = 0;
+    k = 0;
+
+    for (int v = 1; v < n; v++) {
+        for (int u = 0; u < v; u++) {
+            if (k == 0) {
+                c = body[i++] - 63;
+                k = 6;
+            }
+            k--;
+
+            if ((c & (1 << k)) != 0) {
+                targets[degree[u]++] = v;
+                targets[degree[v]++] = u;
+            }
+        }
+    }
+
+    free(degree);
+    return (PyObject*)self;
+}
+
+// Wczytuje graf z formatu sparse6. Powtrzone krawdzie i ptle s pomijane tak jak
+// w adjacencyListLoadSparse6. Tekst jest dekodowany dwukrotnie: najpierw stopnie, potem ssiedzi.
+static PyObject* csrFromSparse6(PyTypeObject* type, const char* text, Py_ssize_t length) {
+    Sparse6Reader reader;
+    int u, v, result;
+
+    if (sparse6Header(&reader, text, length) < 0) {
+        return NULL;
+    }
+
+    int n = reader.n;
+    int64_t* degree = (int64_t*)calloc((size_t)n + 1, sizeof(int64_t));
+    int* last = (int*)malloc(((size_t)n + 1) * sizeof(int));
+    if (degree == NULL || last == NULL) {
+        free(degree);
+        free(last);
+        return PyErr_NoMemory();
+    }
+
+    for (int i = 0; i < n; i++) {
+        last[i] = -1;
+    }
+    while ((result = sparse6Next(&reader, &u, &v)) > 0) {
+        if (u != v && last[u] != v) {
+            last[u] = v;
+            degree[u]++;
+            degree[v]++;
+        }
+    }
+
+    CSRGraph* self = NULL;
+    int64_t* offsets;
+    int32_t* targets;
+    int64_t arcs = 0;
+    for (int i = 0; i < n; i++) {
+        arcs += degree[i];
+    }
+
+    if (result < 0) {
+        sparse6CharacterError();
+        goto done;
+    }
+    self = csrAlloc(type, n, arcs, &offsets, &targets);
+    if (self == NULL) {
+        goto done;
+    }
+
+    offsets[0] = 0;
+    for (int i = 0; i < n; i++) {
+        offsets[i + 1] = offsets[i] + degree[i];
+        degree[i] = offsets[i];
+        last[i] = -1;
+    }
+
+    sparse6Open(&reader, text, length);
+    while (sparse6Next(&reader, &u, &v) > 0) {
+        if (u != v && last[u] != v) {
+            last[u] = v;
+            targets[degree[u]++] = v;
+            targets[degree[v]++] = u;
+        }
+    }
+
+    // Wiersz jest posortowany, jeli w tekcie krawdzie o wsplnym v szy rosnco
+    // (tak zapisuje je to_sparse6); w przeciwnym razie sortujemy go tutaj
+    for (int i = 0; i < n; i++) {
+        for (int64_t j = offsets[i] + 1; j < offsets[i + 1]; j++) {
+            if (targets[j - 1] > targets[j]) {
+                qsort(targets + offsets[i], (size_t)(offsets[i + 1] - offsets[i]), sizeof(int32_t), compareInt32);
+                break;
+            }
+        }
+    }
+
+done:
+    free(degree);
+    free(last);
+    return (PyObject*)self;
+}
+
+// Wczytuje graf skierowany z formatu digraph6. Bit i * n + j macierzy oznacza uk i -> j;
+// ptle s pomijane. Macierz jest zapisana wierszami, wic wiersze CSR wychodz posortowane.
+static PyObject* csrFromDigraph6(PyTypeObject* type, const char* text, Py_ssize_t length) {
+    int n;
+    const char* body = digraph6Header(text, length, &n);
+    if (body == NULL) {
+        return NULL;
+    }
+
+    int64_t* degree = (int64_t*)calloc((size_t)n + 1, sizeof(int64_t));
+    if (degree == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    int64_t arcs = 0;
+    int c = 0;
+    long long i = 0;
+    int k = 0;
+
+    for (int u = 0; u < n; u++) {
+        for (int v = 0; v < n; v++) {
+            if (k == 0) {
+                c = body[i++] - 63;
+                k = 6;
+            }
+            k--;
+
+            if ((c & (1 << k)) != 0 && u != v) {
+                degree[u]++;
+                arcs++;
+            }
+        }
+    }
+
+    int64_t* offsets;
+    int32_t* targets;
+    CSRGraph* self = csrAlloc(type, n, arcs, &offsets, &targets);
+    if (self == NULL) {
+        free(degree);
+        return NULL;
+    }
+    self->directed = 1;
+
+    offsets[0] = 0;
+    for (int u = 0; u < n; u++) {
+        offsets[u + 1] = offsets[u] + degree[u];
+    }
+
+    c = 0;
+    i = 0;
+    k = 0;
+    int64_t position = 0;
+
+    for (int u = 0; u < n; u++) {
+        for (int v = 0; v < n; v++) {
+            if (k == 0) {
+                c = body[i++] - 63;
+                k = 6;
+            }
+            k--;
+
+            if ((c & (1 << k)) != 0 && u != v) {
+                targets[position++] = v;
+            }
+        }
+    }
+
+    free(degree);
+    return (PyObject*)self;
+}
+
+// Buduje graf CSR z tekstu w formacie g6, sparse6 (':') albo digraph6 ('&').
+static PyObject* csrFromText(PyTypeObject* type, const char* text, Py_ssize_t length) {
+    if (length > 0 && text[0] == ':') {
+        return csrFromSparse6(type, text, length);
+    }
+    if (length > 0 && text[0] == '&') {
+        return csrFromDigraph6(type, text, length);
+    }
+    return csrFromG6(type, text, length);
+}
+
+static PyObject* CSRGraph_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "text", NULL };
+    char* text = "?";
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "|s", kwlist, &text)) {
+        return NULL;
+    }
+
+    return csrFromText(type, text, (Py_ssize_t)strlen(text));
+}
+
+static void CSRGraph_dealloc(CSRGraph* self) {
+    if (self->data.obj != NULL) {
+        PyBuffer_Release(&self->data);
+    }
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// Zwraca wierzchoek jako indeks albo -1 (z wyjtkiem), gdy jest ujemny.
+static int csrVertexArgument(PyObject* args, int* vertex) {
+    if (!PyArg_ParseTuple(args, "i", vertex)) {
+        return -1;
+    }
+    if (*vertex < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return -1;
+    }
+    return 0;
+}
+
+static int csrHasEdge(CSRGraph* self, int u, int v) {
+    if (u >= self->n || v >= self->n) {
+        return 0;
+    }
+
+    // Wyszukiwanie binarne w posortowanym wierszu
+    int64_t low = self->offsets[u], high = self->offsets[u + 1];
+    while (low < high) {
+        int64_t middle = low + (high - low) / 2;
+        if (self->targets[middle] < v) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low < self->offsets[u + 1] && self->targets[low] == v;
+}
+
+static PyObject* CSRGraph_number_of_vertices(CSRGraph* self) {
+    return PyLong_FromLong(self->n);
+}
+
+static PyObject* CSRGraph_vertices(CSRGraph* self) {
+    PyObject* vertex_set = PySet_New(NULL);
+    if (vertex_set == NULL) {
+        return NULL;
+    }
+
+    for (int v = 0; v < self->n; v++) {
+        PyObject* vertex = PyLong_FromLong(v);
+        if (vertex == NULL || PySet_Add(vertex_set, vertex) < 0) {
+            Py_XDECREF(vertex);
+            Py_DECREF(vertex_set);
+            return NULL;
+        }
+        Py_DECREF(vertex);
+    }
+
+    return vertex_set;
+}
+
+static PyObject* CSRGraph_vertex_degree(CSRGraph* self, PyObject* args) {
+    int vertex;
+
+    if (csrVertexArgument(args, &vertex) < 0) {
+        return NULL;
+    }
+    if (vertex >= self->n) {
+        return PyLong_FromLong(0);
+    }
+
+    return PyLong_FromLongLong(self->offsets[vertex + 1] - self->offsets[vertex]);
+}
+
+static PyObject* CSRGraph_vertex_neighbors(CSRGraph* self, PyObject* args) {
+    int vertex;
+
+    if (csrVertexArgument(args, &vertex) < 0) {
+        return NULL;
+    }
+
+    PyObject* neighbors_set = PySet_New(NULL);
+    if (neighbors_set == NULL || vertex >= self->n) {
+        return neighbors_set;
+    }
+
+    for (int64_t i = self->offsets[vertex]; i < self->offsets[vertex + 1]; i++) {
+        PyObject* neighbor = PyLong_FromLong(self->targets[i]);
+        if (neighbor == NULL || PySet_Add(neighbors_set, neighbor) < 0) {
+            Py_XDECREF(neighbor);
+            Py_DECREF(neighbors_set);
+            return NULL;
+        }
+        Py_DECREF(neighbor);
+    }
+
+    return neighbors_set;
+}
+
+// Algorytmy dla grafw nieskierowanych odrzucaj grafy wczytane z digraph6.
+static int csrRequireUndirected(CSRGraph* self) {
+    if (self->directed) {
+        PyErr_SetString(PyExc_ValueError, "Operacja wymaga grafu nieskierowanego");
+        return -1;
+    }
+    return 0;
+}
+
+// Liczba krawdzi (w grafie skierowanym: ukw).
+static int64_t csrEdgeCount(CSRGraph* self) {
+    return self->directed ? self->offsets[self->n] : self->offsets[self->n] / 2;
+}
+
+static PyObject* CSRGraph_is_directed(CSRGraph* self) {
+    return PyBool_FromLong(self->directed);
+}
+
+static PyObject* CSRGraph_number_of_edges(CSRGraph* self) {
+    return PyLong_FromLongLong(csrEdgeCount(self));
+}
+
+static PyObject* CSRGraph_edges(CSRGraph* self) {
+    PyObject* edges_set = PySet_New(NULL);
+    if (edges_set == NULL) {
+        return NULL;
+    }
+
+    for (int u = 0; u < self->n; u++) {
+        for (int64_t i = self->offsets[u]; i < self->offsets[u + 1]; i++) {
+            if (self->targets[i] <= u && !self->directed) {
+                continue;
+            }
+            PyObject* edge_tuple = Py_BuildValue("(ii)", u, self->targets[i]);
+            if (edge_tuple == NULL || PySet_Add(edges_set, edge_tuple) < 0) {
+                Py_XDECREF(edge_tuple);
+                Py_DECREF(edges_set);
+                return NULL;
+            }
+            Py_DECREF(edge_tuple);
+        }
+    }
+
+    return edges_set;
+}
+
+static PyObject* CSRGraph_is_edge(CSRGraph* self, PyObject* args) {
+    int u, v;
+
+    if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
+        return NULL;
+    }
+    if (u < 0 || v < 0) {
+        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+        return NULL;
+    }
+
+    return PyBool_FromLong(csrHasEdge(self, u, v));
+}
+
+// Skadowe spjnoci (i dwudzielno) grafu nieskierowanego liczone silnikiem BFS.
+// Zwraca -1, gdy brakuje pamici.
+static int csrComponents(CSRGraph* self, int* bipartite) {
+    return csrArraysComponents(self->n, self->offsets, self->targets, bipartite);
+}
+
+static PyObject* CSRGraph_is_bipartite(CSRGraph* self) {
+    if (csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+    int bipartite;
+    if (csrComponents(self, &bipartite) < 0) {
+        return PyErr_NoMemory();
+    }
+    return PyBool_FromLong(bipartite);
+}
+
+static PyObject* CSRGraph_connected_components(CSRGraph* self) {
+    if (csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+    int components = csrComponents(self, NULL);
+    if (components < 0) {
+        return PyErr_NoMemory();
+    }
+    return PyLong_FromLong(components);
+}
+
+static PyObject* CSRGraph_is_tree(CSRGraph* self) {
+    if (csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+    if (self->n == 0) {
+        PyErr_SetString(PyExc_ValueError, "Graf nie ma wierzchokw");
+        return NULL;
+    }
+    if (self->offsets[self->n] / 2 != self->n - 1) {
+        Py_RETURN_FALSE;
+    }
+
+    int components = csrComponents(self, NULL);
+    if (components < 0) {
+        return PyErr_NoMemory();
+    }
+    return PyBool_FromLong(components == 1);
+}
+
+static PyObject* CSRGraph_is_complete_bipartite(CSRGraph* self) {
+    if (csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+    if (self->n == 0) {
+        PyErr_SetString(PyExc_ValueError, "Graf nie ma wierzchokw");
+        return NULL;
+    }
+
+    // Jedn stron podziau wyznaczaj ssiedzi wierzchoka 0
+    char* side = (char*)calloc((size_t)self->n, 1);
+    if (side == NULL) {
+        return PyErr_NoMemory();
+    }
+    for (int64_t i = self->offsets[0]; i < self->offsets[1]; i++) {
+        side[self->targets[i]] = 1;
+    }
+
+    int64_t sizes[2] = { self->n - (self->offsets[1] - self->offsets[0]), self->offsets[1] - self->offsets[0] };
+    int result = 1;
+    for (int v = 0; v < self->n && result; v++) {
+        for (int64_t i = self->offsets[v]; i < self->offsets[v + 1]; i++) {
+            if (side[self->targets[i]] == side[v]) {
+                result = 0;
+            }
+        }
+        if (self->offsets[v + 1] - self->offsets[v] != sizes[1 - side[v]]) {
+            result = 0;
+        }
+    }
+
+    free(side);
+    return PyBool_FromLong(result);
+}
+
+static PyObject* CSRGraph_number_of_triangles(CSRGraph* self) {
+    if (csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+    // Dla kadej krawdzi u < v scalamy posortowane wiersze u i v, liczc wsplnych
+    // ssiadw w > v, dziki czemu kady trjkt jest liczony raz
+    long long triangles = 0;
+    for (int u = 0; u < self->n; u++) {
+        for (int64_t a = self->offsets[u]; a < self->offsets[u + 1]; a++) {
+            int v = self->targets[a];
+            if (v <= u) {
+                continue;
+            }
+            int64_t i = a + 1, iEnd = self->offsets[u + 1];
+            int64_t j = self->offsets[v], jEnd = self->offsets[v + 1];
+            while (j < jEnd && self->targets[j] <= v) {
+                j++;
+            }
+            while (i < iEnd && j < jEnd) {
+                if (self->targets[i] < self->targets[j]) {
+                    i++;
+                }
+                else if (self->targets[i] > self->targets[j]) {
+                    j++;
+                }
+                else {
+                    triangles++;
+                    i++;
+                    j++;
+                }
+            }
+        }
+    }
+
+    return PyLong_FromLongLong(triangles);
+}
+
+static PyObject* CSRGraph_degree_sequence(CSRGraph* self) {
+    int maxDegree = 0;
+    for (int v = 0; v < self->n; v++) {
+        if (self->offsets[v + 1] - self->offsets[v] > maxDegree) {
+            maxDegree = (int)(self->offsets[v + 1] - self->offsets[v]);
+        }
+    }
+
+    int* histogram = (int*)calloc((size_t)maxDegree + 1, sizeof(int));
+    if (histogram == NULL) {
+        return PyErr_NoMemory();
+    }
+    for (int v = 0; v < self->n; v++) {
+        histogram[self->offsets[v + 1] - self->offsets[v]]++;
+    }
+
+    PyObject* result = degreeList(histogram, maxDegree, self->n);
+    free(histogram);
+    return result;
+}
+
+// Zwraca fragment bufora grafu jako memoryview o podanym formacie, bez kopiowania.
+static PyObject* csrSlice(CSRGraph* self, const void* start, Py_ssize_t size, const char* format) {
+    PyObject* view = PyMemoryView_FromObject(self->data.obj);
+    if (view == NULL) {
+        return NULL;
+    }
+
+    Py_ssize_t begin = (const char*)start - (const char*)self->data.buf;
+    PyObject* slice = PySequence_GetSlice(view, begin, begin + size);
+    Py_DECREF(view);
+    if (slice == NULL) {
+        return NULL;
+    }
+
+    PyObject* result = PyObject_CallMethod(slice, "cast", "s", format);
+    Py_DECREF(slice);
+    return result;
+}
+
+// Zwraca ssiedztwo jako par memoryview (offsets: int64, targets: int32) wskazujcych wprost
+// na tablice grafu. CSRGraph, podobnie jak AdjacencyList, nie implementuje protokou bufora:
+// bufor opisuje jedn tablic jednego typu, a CSR to dwie tablice rnych typw.
+static PyObject* CSRGraph_adjacency_csr(CSRGraph* self) {
+    PyObject* offsets = csrSlice(self, self->offsets, ((Py_ssize_t)self->n + 1) * (Py_ssize_t)sizeof(int64_t), "q");
+    PyObject* targets = csrSlice(self, self->targets, (Py_ssize_t)self->offsets[self->n] * (Py_ssize_t)sizeof(int32_t), "i");
+    if (offsets == NULL || targets == NULL) {
+        Py_XDECREF(offsets);
+        Py_XDECREF(targets);
+        return NULL;
+    }
+    return Py_BuildValue("(NN)", offsets, targets);
+}
+
+static PyObject* CSRGraph_edge_array(CSRGraph* self) {
+    PyObject* bytes = PyBytes_FromStringAndSize(NULL, (Py_ssize_t)csrEdgeCount(self) * 2 * (Py_ssize_t)sizeof(int32_t));
+    if (bytes == NULL) {
+        return NULL;
+    }
+    int32_t* pairs = (int32_t*)PyBytes_AS_STRING(bytes);
+
+    for (int u = 0; u < self->n; u++) {
+        for (int64_t i = self->offsets[u]; i < self->offsets[u + 1]; i++) {
+            if (self->targets[i] > u || self->directed) {
+                *pairs++ = u;
+                *pairs++ = self->targets[i];
+            }
+        }
+    }
+
+    return bytesView(bytes, "i");
+}
+
+// Dugo zapisu grafu: g6 albo, dla grafu skierowanego, digraph6 (n * n bitw).
+static Py_ssize_t csrG6Length(CSRGraph* self) {
+    if (self->directed) {
+        return 1 + g6OrderLength(self->n) + (Py_ssize_t)(((long long)self->n * self->n + 5) / 6);
+    }
+    return g6Length(self->n);
+}
+
+static void csrWriteG6(CSRGraph* self, char* out) {
+    if (self->directed) {
+        out[0] = '&';
+        char* body = out + 1 + g6WriteOrder(out + 1, self->n);
+        long long length = ((long long)self->n * self->n + 5) / 6;
+
+        memset(body, 0, (size_t)length);
+        for (int u = 0; u < self->n; u++) {
+            for (int64_t i = self->offsets[u]; i < self->offsets[u + 1]; i++) {
+                long long bit = (long long)u * self->n + self->targets[i];
+                body[bit / 6] |= (char)(32 >> (bit % 6));
+            }
+        }
+        for (long long i = 0; i < length; i++) {
+            body[i] += 63;
+        }
+        return;
+    }
+
+    char* body = g6Begin(out, self->n);
+
+    for (int v = 0; v < self->n; v++) {
+        for (int64_t i = self->offsets[v]; i < self->offsets[v + 1] && self->targets[i] < v; i++) {
+            g6SetEdge(body, self->targets[i], v);
+        }
+    }
+    g6Finish(body, self->n);
+}
+
+// Zwraca graf w formacie g6 (graf skierowany w formacie digraph6).
+static PyObject* CSRGraph_to_g6(CSRGraph* self) {
+    PyObject* text = PyUnicode_New(csrG6Length(self), 127);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    csrWriteG6(self, (char*)PyUnicode_1BYTE_DATA(text));
+    return text;
+}
+
+static PyObject* CSRGraph_canonical_g6(CSRGraph* self) {
+    if (csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+    return canonicalText(CSRGraph_to_g6(self));
+}
+
+static PyObject* CSRGraph_to_sparse6(CSRGraph* self) {
+    if (csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+
+    PyObject* text = PyUnicode_New(sparse6Bound(self->n, csrEdgeCount(self)), 127);
+    if (text == NULL) {
+        return NULL;
+    }
+
+    char* out = (char*)PyUnicode_1BYTE_DATA(text);
+    Sparse6Writer writer;
+    sparse6Begin(&writer, out, self->n);
+    for (int v = 0; v < self->n; v++) {
+        for (int64_t i = self->offsets[v]; i < self->offsets[v + 1] && self->targets[i] < v; i++) {
+            sparse6Edge(&writer, self->targets[i], v);
+        }
+    }
+
+    if (PyUnicode_Resize(&text, sparse6End(&writer, out)) < 0) {
+        return NULL;
+    }
+    return text;
+}
+
+static PyObject* csrDistances(CSRGraph* self, PyObject* args, PyObject* kwds, int query) {
+    int threads = parseThreads(args, kwds);
+    if (threads < 0 || csrRequireUndirected(self) < 0) {
+        return NULL;
+    }
+    return distanceQuery(self->n, self->offsets, self->targets, query, threads);
+}
+
+static PyObject* CSRGraph_distance_matrix(CSRGraph* self, PyObject* args, PyObject* kwds) {
+    return csrDistances(self, args, kwds, DISTANCE_MATRIX);
+}
+
+static PyObject* CSRGraph_eccentricities(CSRGraph* self, PyObject* args, PyObject* kwds) {
+    return csrDistances(self, args, kwds, DISTANCE_ECCENTRICITIES);
+}
+
+static PyObject* CSRGraph_diameter(CSRGraph* self, PyObject* args, PyObject* kwds) {
+    return csrDistances(self, args, kwds, DISTANCE_DIAMETER);
+}
+
+static PyObject* CSRGraph_wiener_index(CSRGraph* self, PyObject* args, PyObject* kwds) {
+    return csrDistances(self, args, kwds, DISTANCE_WIENER_INDEX);
+}
+
+static PyMethodDef CSRGraph_methods[] = {
+    {"number_of_vertices", (PyCFunction)CSRGraph_number_of_vertices, METH_NOARGS},
+    {"vertices", (PyCFunction)CSRGraph_vertices, METH_NOARGS},
+    {"vertex_degree", (PyCFunction)CSRGraph_vertex_degree, METH_VARARGS},
+    {"vertex_neighbors", (PyCFunction)CSRGraph_vertex_neighbors, METH_VARARGS},
+    {"number_of_edges", (PyCFunction)CSRGraph_number_of_edges, METH_NOARGS},
+    {"edges", (PyCFunction)CSRGraph_edges, METH_NOARGS},
+    {"is_edge", (PyCFunction)CSRGraph_is_edge, METH_VARARGS},
+    {"is_bipartite", (PyCFunction)CSRGraph_is_bipartite, METH_NOARGS},
+    {"connected_components", (PyCFunction)CSRGraph_connected_components, METH_NOARGS},
+    {"is_tree", (PyCFunction)CSRGraph_is_tree, METH_NOARGS},
+    {"distance_matrix", (PyCFunction)(void(*)(void))CSRGraph_distance_matrix, METH_VARARGS | METH_KEYWORDS},
+    {"eccentricities", (PyCFunction)(void(*)(void))CSRGraph_eccentricities, METH_VARARGS | METH_KEYWORDS},
+    {"diameter", (PyCFunction)(void(*)(void))CSRGraph_diameter, METH_VARARGS | METH_KEYWORDS},
+    {"wiener_index", (PyCFunction)(void(*)(void))CSRGraph_wiener_index, METH_VARARGS | METH_KEYWORDS},
+    {"is_complete_bipartite", (PyCFunction)CSRGraph_is_complete_bipartite, METH_NOARGS},
+    {"number_of_triangles", (PyCFunction)CSRGraph_number_of_triangles, METH_NOARGS},
+    {"degree_sequence", (PyCFunction)CSRGraph_degree_sequence, METH_NOARGS},
+    {"adjacency_csr", (PyCFunction)CSRGraph_adjacency_csr, METH_NOARGS},
+    {"edge_array", (PyCFunction)CSRGraph_edge_array, METH_NOARGS},
+    {"to_g6", (PyCFunction)CSRGraph_to_g6, METH_NOARGS},
+    {"canonical_g6", (PyCFunction)CSRGraph_canonical_g6, METH_NOARGS},
+    {"to_sparse6", (PyCFunction)CSRGraph_to_sparse6, METH_NOARGS},
+    {"is_directed", (PyCFunction)CSRGraph_is_directed, METH_NOARGS},
+    {NULL, NULL}
+};
+
+static PyTypeObject CSRGraphType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "simple_graphs.CSRGraph",          /* tp_name */
+    sizeof(CSRGraph),                  /* tp_basicsize */
+    0,                                 /* tp_itemsize */
+    (destructor)CSRGraph_dealloc,      /* tp_dealloc */
+    0,                                 /* tp_vectorcall_offset */
+    0,                                 /* tp_getattr */
+    0,                                 /* tp_setattr */
+    0,                                 /* tp_as_async */
+    0,                                 /* tp_repr */
+    0,                                 /* tp_as_number */
+    0,                                 /* tp_as_sequence */
+    0,                                 /* tp_as_mapping */
+    0,                                 /* tp_hash */
+    0,                                 /* tp_call */
+    0,                                 /* tp_str */
+    0,                                 /* tp_getattro */
+    0,                                 /* tp_setattro */
+    0,                                 /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                /* tp_flags */
+    0,                                 /* tp_doc */
+    0,                                 /* tp_traverse */
+    0,                                 /* tp_clear */
+    0,                                 /* tp_richcompare */
+    0,                                 /* tp_weaklistoffset */
+    0,                                 /* tp_iter */
+    0,                                 /* tp_iternext */
+    CSRGraph_methods,                  /* tp_methods */
+    0,                                 /* tp_members */
+    0,                                 /* tp_getset */
+    0,                                 /* tp_base */
+    0,                                 /* tp_dict */
+    0,                                 /* tp_descr_get */
+    0,                                 /* tp_descr_set */
+    0,                                 /* tp_dictoffset */
+    0,                                 /* tp_init */
+    0,                                 /* tp_alloc */
+    CSRGraph_new,                      /* tp_new */
+};
+
+// Zamraa graf do postaci CSR. Istniejce wierzchoki s numerowane kolejno od 0
+// w rosncej kolejnoci (usunite wierzchoki nie zostawiaj luk).
+static PyObject* freeze(AdjacencyList* self) {
+    int* label = (int*)malloc(((size_t)self->capacity + 1) * sizeof(int));
+    if (label == NULL) {
+        return PyErr_NoMemory();
+    }
+
+    int n = 0;
+    int64_t arcs = 0;
+    for (int v = 0; v < self->capacity; v++) {
+        label[v] = self->adj_list[v] != NULL ? n++ : -1;
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            arcs += current->vertex != v;
+        }
+    }
+
+    int64_t* offsets;
+    int32_t* targets;
+    CSRGraph* result = csrAlloc(&CSRGraphType, n, arcs, &offsets, &targets);
+    if (result == NULL) {
+        free(label);
+        return NULL;
+    }
+
+    offsets[0] = 0;
+    for (int v = 0; v < self->capacity; v++) {
+        if (label[v] < 0) {
+            continue;
+        }
+        int64_t position = offsets[label[v]];
+        for (Node* current = self->adj_list[v]; current != NULL; current = current->next) {
+            if (current->vertex != v) {
+                targets[position++] = label[current->vertex];
+            }
+        }
+        qsort(targets + offsets[label[v]], (size_t)(position - offsets[label[v]]), sizeof(int32_t), compareInt32);
+        offsets[label[v] + 1] = position;
+    }
+
+    free(label);
+    return (PyObject*)result;
+}
+
+// Zwraca ssiedztwo w formacie CSR jako par memoryview (offsets: int64, targets: int32).
+// Wierzchoki maj kolejne numery 0..n-1 w rosncej kolejnoci (jak w freeze() i to_g6()),
+// a ssiedzi wierzchoka i to targets[offsets[i]:offsets[i + 1]], posortowani rosnco.
+static PyObject* adjacency_csr(AdjacencyList* self) {
+    PyObject* frozen = freeze(self);
+    if (frozen == NULL) {
+        return NULL;
+    }
+
+    // Widoki trzymaj referencj do tablic grafu, wic sam graf moe zosta zwolniony
+    PyObject* result = CSRGraph_adjacency_csr((CSRGraph*)frozen);
+    Py_DECREF(frozen);
+    return result;
+}
+
+// Tworzy obiekt grafu podanego typu (AdjacencyList, AdjacencyMatrix, CSRGraph lub ich podklasy)
+// z jednej linii g6, z pominiciem parsowania argumentw __init__.
+static PyObject* graphFromG6(PyTypeObject* type, const char* text, Py_ssize_t length) {
+    if (PyType_IsSubtype(type, &CSRGraphType)) {
+        return csrFromText(type, text, length);
+    }
+
+    PyObject* graph = emptyGraph(type);
+    if (graph == NULL) {
+        return NULL;
+    }
+
+    int result;
+    if (PyType_IsSubtype(type, &AdjacencyMatrixType)) {
+        result = adjacencyMatrixLoadG6((AdjacencyMatrix*)graph, text, length);
+    }
+    else {
+        result = adjacencyListLoadG6((AdjacencyList*)graph, text, length);
+    }
+
+    if (result < 0) {
+        Py_DECREF(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+// Operacje, ktre map_corpus potrafi policzy dla kadego grafu korpusu.
+enum {
+    CORPUS_NUMBER_OF_VERTICES,
+    CORPUS_NUMBER_OF_EDGES,
+    CORPUS_IS_BIPARTITE,
+    CORPUS_NUMBER_OF_TRIANGLES,
+    CORPUS_CONNECTED_COMPONENTS,
+    CORPUS_IS_TREE
+};
+
+static const char* corpusOperations[] = {
+    "number_of_vertices",
+    "number_of_edges",
+    "is_bipartite",
+    "number_of_triangles",
+    "connected_components",
+    "is_tree",
+    NULL
+};
+
+// Wtki robocze pobieraj grafy porcjami o tym rozmiarze ze wsplnego licznika.
+#define CORPUS_CHUNK 64
+
+typedef struct {
+    const char* data;
+    const Py_ssize_t* starts;    // pocztek i dugo kadej linii g6
+    const Py_ssize_t* lengths;
+    Py_ssize_t count;
+    int operation;
+    int64_t* results;            // -1: niepoprawna linia, -2: brak pamici, -3: graf za duy
+    char* canonical;             // dla dedupe_isomorphic: bufor na postacie kanoniczne
+    const Py_ssize_t* outputs;   // (wtedy results to ich skrty), graf i od outputs[i]
+    volatile Py_ssize_t next;    // pierwszy graf, ktrego nikt jeszcze nie pobra
+} CorpusJob;
+
+static int64_t evaluateOperation(BitGraph* g, int operation) {
+    int bipartite;
+
+    switch (operation) {
+    case CORPUS_NUMBER_OF_VERTICES:
+        return g->n;
+    case CORPUS_NUMBER_OF_EDGES:
+        return bitGraphEdges(g);
+    case CORPUS_IS_BIPARTITE:
+        bitGraphComponents(g, &bipartite);
+        return bipartite;
+    case CORPUS_NUMBER_OF_TRIANGLES:
+        return countTriangles(g->rows, g->n, g->words);
+    case CORPUS_CONNECTED_COMPONENTS:
+        return bitGraphComponents(g, NULL);
+    case CORPUS_IS_TREE:
+        return g->n > 0 && bitGraphEdges(g) == g->n - 1 && bitGraphComponents(g, NULL) == 1;
+    }
+    return -1;
+}
+
+// Ptla wtku roboczego: pobiera kolejne porcje grafw, dopki jakie zostay. Nie jest to
+// podkradanie pracy (work stealing) z kolejek innych wtkw, tylko wsplny licznik atomowy
+// job->next: wtki, ktre skocz wczeniej, zabieraj nastpne porcje, wic nierwne
+// rozmiary grafw nie blokuj pozostaych.
+static void corpusWorker(void* argument) {
+    CorpusJob* job = (CorpusJob*)argument;
+    BitGraph g = { 0, 0, NULL, NULL, 0 };
+
+    while (1) {
+        Py_ssize_t first = atomicFetchAdd(&job->next, CORPUS_CHUNK);
+        if (first >= job->count) {
+            break;
+        }
+        Py_ssize_t last = first + CORPUS_CHUNK < job->count ? first + CORPUS_CHUNK : job->count;
+
+        for (Py_ssize_t i = first; i < last; i++) {
+            int loaded = bitGraphLoadG6(&g, job->data + job->starts[i], job->lengths[i]);
+            if (loaded < 0) {
+                job->results[i] = loaded;
+            }
+            else if (job->canonical != NULL) {
+                // Graf musi zmieci si w miejscu wyliczonym z nagwka linii
+                job->results[i] = g6Length(g.n) == job->outputs[i + 1] - job->outputs[i] ?
+                    canonicalG6(&g, job->canonical + job->outputs[i]) : -1;
+            }
+            else {
+                job->results[i] = evaluateOperation(&g, job->operation);
+            }
+        }
+    }
+
+    bitGraphFree(&g);
+}
+
+// Opcjonalne nagwki plikw w formatach g6, sparse6 i digraph6.
+static const char* formatHeaders[] = { ">>graph6<<", ">>sparse6<<", ">>digraph6<<", NULL };
+
+// Usuwa z linii kocowe '\r' i nagwek formatu; zwraca now dugo linii.
+static Py_ssize_t trimG6Line(const char** line, Py_ssize_t length) {
+    if (length > 0 && (*line)[length - 1] == '\r') {
+        length--;
+    }
+    for (int i = 0; formatHeaders[i] != NULL; i++) {
+        size_t headerLength = strlen(formatHeaders[i]);
+        if ((size_t)length >= headerLength && memcmp(*line, formatHeaders[i], headerLength) == 0) {
+            *line += headerLength;
+            length -= (Py_ssize_t)headerLength;
+            break;
+        }
+    }
+    return length;
+}
+
+// Dzieli bufor na linie g6 (pomijajc puste linie i nagwki >>graph6<< itp.).
+// Zwraca liczb linii albo -1, gdy brakuje pamici.
+static Py_ssize_t splitG6Lines(const char* data, Py_ssize_t length, Py_ssize_t** starts, Py_ssize_t** lengths) {
+    Py_ssize_t capacity = 1024;
+    Py_ssize_t count = 0;
+    *starts = (Py_ssize_t*)malloc((size_t)capacity * sizeof(Py_ssize_t));
+    *lengths = (Py_ssize_t*)malloc((size_t)capacity * sizeof(Py_ssize_t));
+
+    const char* position = data;
+    const char* end = data + length;
+
+    while (*starts != NULL && *lengths != NULL && position < end) {
+        const char* lineEnd = memchr(position, '\n', (size_t)(end - position));
+        if (lineEnd == NULL) {
+            lineEnd = end;
+        }
+
+        const char* line = position;
+        Py_ssize_t lineLength = trimG6Line(&line, lineEnd - line);
+        position = lineEnd + 1;
+
+        if (lineLength == 0) {
+            continue;
+        }
+
+        if (count == capacity) {
+            capacity *= 2;
+            Py_ssize_t* newStarts = (Py_ssize_t*)realloc(*starts, (size_t)capacity * sizeof(Py_ssize_t));
+            if (newStarts == NULL) {
+                goto error;
+            }
+            *starts = newStarts;
+            Py_ssize_t* newLengths = (Py_ssize_t*)realloc(*lengths, (size_t)capacity * sizeof(Py_ssize_t));
+            if (newLengths == NULL) {
+                goto error;
+            }
+            *lengths = newLengths;
+        }
+        (*starts)[count] = line - data;
+        (*lengths)[count] = lineLength;
+        count++;
+    }
+
+    if (*starts == NULL || *lengths == NULL) {
+        goto error;
+    }
+    return count;
+
+error:
+    // Przy ostatniej linii bez znaku nowej linii position jest ju za kocem bufora,
+    // wic bd musi by zgoszony wprost, a nie wykrywany po ptli
+    free(*starts);
+    free(*lengths);
+    *starts = NULL;
+    *lengths = NULL;
+    return -1;
+}
+
+// Dekoduje korpus g6 i liczy wskazan operacj dla kadego grafu w wielu wtkach,
+// bez GIL. Zwraca memoryview z wynikami typu int64 (wartoci logiczne jako 0/1).
+// Grafy s wczytywane do macierzy bitowych, wic mog mie co najwyej
+// BITGRAPH_MAX_VERTICES wierzchokw.
+static PyObject* map_corpus(PyObject* module, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "data", "op", "threads", NULL };
+    Py_buffer data;
+    const char* name;
+    int threads = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*s|i", kwlist, &data, &name, &threads)) {
+        return NULL;
+    }
+
+    int operation = -1;
+    for (int i = 0; corpusOperations[i] != NULL; i++) {
+        if (strcmp(name, corpusOperations[i]) == 0) {
+            operation = i;
+        }
+    }
+    if (operation < 0) {
+        PyBuffer_Release(&data);
+        PyErr_Format(PyExc_ValueError, "Nieznana operacja: %s", name);
+        return NULL;
+    }
+    if (threads <= 0) {
+        threads = cpuCount();
+    }
+
+    Py_ssize_t* starts;
+    Py_ssize_t* lengths;
+    Py_ssize_t count;
+
+    Py_BEGIN_ALLOW_THREADS
+    count = splitG6Lines((const char*)data.buf, data.len, &starts, &lengths);
+    Py_END_ALLOW_THREADS
+
+    if (count < 0) {
+        PyBuffer_Release(&data);
+        return PyErr_NoMemory();
+    }
+
+    PyObject* bytes = PyBytes_FromStringAndSize(NULL, count * (Py_ssize_t)sizeof(int64_t));
+    if (bytes == NULL) {
+        free(starts);
+        free(lengths);
+        PyBuffer_Release(&data);
+        return NULL;
+    }
+
+    CorpusJob job;
+    job.data = (const char*)data.buf;
+    job.starts = starts;
+    job.lengths = lengths;
+    job.count = count;
+    job.operation = operation;
+    job.results = (int64_t*)PyBytes_AS_STRING(bytes);
+    job.canonical = NULL;
+    job.outputs = NULL;
+    job.next = 0;
+
+    if (threads > count / CORPUS_CHUNK + 1) {
+        threads = (int)(count / CORPUS_CHUNK + 1);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    runWorkers(corpusWorker, &job, threads);
+    Py_END_ALLOW_THREADS
+
+    free(starts);
+    free(lengths);
+    PyBuffer_Release(&data);
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (job.results[i] == -2) {
+            Py_DECREF(bytes);
+            return PyErr_NoMemory();
+        }
+        if (job.results[i] == -3) {
+            Py_DECREF(bytes);
+            PyErr_Format(PyExc_ValueError, "Graf numer %zd w korpusie ma ponad %d %s", i, BITGRAPH_MAX_VERTICES, "wierzchokw");
+            return NULL;
+        }
+        if (job.results[i] < 0) {
+            Py_DECREF(bytes);
+            PyErr_Format(PyExc_ValueError, "Niepoprawny graf g6 numer %zd w korpusie", i);
+            return NULL;
+        }
+    }
+
+    return bytesView(bytes, "q");
+}
+
+// Wyznacza klasy izomorfizmu grafw korpusu g6/sparse6 (co najwyej 64 wierzchoki):
+// postacie kanoniczne liczone s rwnolegle bez GIL, a nastpnie grupowane wedug
+// skrtu (z dokadnym porwnaniem tekstu). Zwraca memoryview int64 z numerami
+// pierwszych grafw kadej klasy, w kolejnoci wystpowania w korpusie.
+static PyObject* dedupe_isomorphic(PyObject* module, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "data", "threads", NULL };
+    Py_buffer data;
+    int threads = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|i", kwlist, &data, &threads)) {
+        return NULL;
+    }
+    if (threads <= 0) {
+        threads = cpuCount();
+    }
+
+    Py_ssize_t* starts;
+    Py_ssize_t* lengths;
+    Py_ssize_t count;
+
+    Py_BEGIN_ALLOW_THREADS
+    count = splitG6Lines((const char*)data.buf, data.len, &starts, &lengths);
+    Py_END_ALLOW_THREADS
+
+    if (count < 0) {
+        PyBuffer_Release(&data);
+        return PyErr_NoMemory();
+    }
+
+    // Posta kanoniczna grafu o n wierzchokach zajmuje g6Length(n) znakw; n odczytujemy
+    // z nagwka, a niepoprawne linie zgosi dopiero wtek roboczy
+    Py_ssize_t* outputs = (Py_ssize_t*)malloc(((size_t)count + 1) * sizeof(Py_ssize_t));
+    int64_t* hashes = (int64_t*)malloc(((size_t)count + 1) * sizeof(int64_t));
+    Py_ssize_t* table = NULL;
+    char* canonical = NULL;
+    PyObject* bytes = NULL;
+    PyObject* result = NULL;
+
+    if (outputs == NULL || hashes == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+    outputs[0] = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        const char* line = (const char*)data.buf + starts[i];
+        int skip = lengths[i] > 0 && line[0] == ':';
+        long long n;
+        g6ReadOrder(line + skip, lengths[i] - skip, &n);
+        if (n > CANONICAL_MAX_VERTICES) {
+            PyErr_SetString(PyExc_ValueError, "Posta kanoniczna jest dostpna dla grafw o co najwyej 64 wierzchokach");
+            goto done;
+        }
+        outputs[i + 1] = outputs[i] + (n >= 0 ? g6Length((int)n) : 0);
+    }
+    canonical = (char*)malloc((size_t)outputs[count] + 1);
+    if (canonical == NULL) {
+        PyErr_NoMemory();
+        goto done;
+    }
+
+    CorpusJob job;
+    job.data = (const char*)data.buf;
+    job.starts = starts;
+    job.lengths = lengths;
+    job.count = count;
+    job.operation = -1;
+    job.results = hashes;
+    job.canonical = canonical;
+    job.outputs = outputs;
+    job.next = 0;
+
+    if (threads > count / CORPUS_CHUNK + 1) {
+        threads = (int)(count / CORPUS_CHUNK + 1);
+    }
+
+    Py_BEGIN_ALLOW_THREADS
+    runWorkers(corpusWorker, &job, threads);
+    Py_END_ALLOW_THREADS
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (hashes[i] == -2) {
+            PyErr_NoMemory();
+            goto done;
+        }
+        if (hashes[i] < 0) {
+            PyErr_Format(PyExc_ValueError, "Niepoprawny graf g6 numer %zd w korpusie", i);
+            goto done;
+        }
+    }
+
+    // Tablica z adresowaniem otwartym numerw grafw reprezentujcych klasy
+    size_t mask = 1;
+    while (mask < 2 * (size_t)count) {
+        mask <<= 1;
+    }
+    mask--;
+    table = (Py_ssize_t*)malloc((mask + 1) * sizeof(Py_ssize_t));
+    bytes = PyBytes_FromStringAndSize(NULL, count * (Py_ssize_t)sizeof(int64_t));
+    if (table == NULL || bytes == NULL) {
+        if (table == NULL) {
+            PyErr_NoMemory();
+        }
+        goto done;
+    }
+    memset(table, 0xFF, (mask + 1) * sizeof(Py_ssize_t));
+
+    int64_t* representatives = (int64_t*)PyBytes_AS_STRING(bytes);
+    Py_ssize_t classes = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        Py_ssize_t length = outputs[i + 1] - outputs[i];
+        size_t slot = (size_t)hashes[i] & mask;
+        while (table[slot] >= 0) {
+            Py_ssize_t j = table[slot];
+            if (hashes[j] == hashes[i] && outputs[j + 1] - outputs[j] == length &&
+                memcmp(canonical + outputs[j], canonical + outputs[i], (size_t)length) == 0) {
+                break;
+            }
+            slot = (slot + 1) & mask;
+        }
+        if (table[slot] < 0) {
+            table[slot] = i;
+            representatives[classes++] = i;
+        }
+    }
+
+    if (_PyBytes_Resize(&bytes, classes * (Py_ssize_t)sizeof(int64_t)) == 0) {
+        result = bytesView(bytes, "q");
+    }
+    bytes = NULL;
+
+done:
+    Py_XDECREF(bytes);
+    free(table);
+    free(canonical);
+    free(hashes);
+    free(outputs);
+    free(starts);
+    free(lengths);
+    PyBuffer_Release(&data);
+    return result;
+}
+
+static int isGraphType(PyTypeObject* type) {
+    return PyType_IsSubtype(type, &AdjacencyListType) || PyType_IsSubtype(type, &AdjacencyMatrixType)
+        || PyType_IsSubtype(type, &CSRGraphType);
+}
+
+// Dekoduje bufor z wieloma grafami g6 rozdzielonymi znakami nowej linii
+// i zwraca list grafw. Linie mog by te w formacie sparse6 (albo digraph6 dla
+// CSRGraph); puste linie i nagwki formatw s pomijane.
+static PyObject* parse_g6_batch(PyObject* module, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "data", "structure", NULL };
+    Py_buffer data;
+    PyTypeObject* type = &AdjacencyListType;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "y*|O!", kwlist, &data, &PyType_Type, &type)) {
+        return NULL;
+    }
+
+    if (!isGraphType(type)) {
+        PyBuffer_Release(&data);
+        PyErr_SetString(PyExc_TypeError, "Nieobsugiwana struktura grafu");
+        return NULL;
+    }
+
+    Py_ssize_t* starts;
+    Py_ssize_t* lengths;
+    Py_ssize_t count = splitG6Lines((const char*)data.buf, data.len, &starts, &lengths);
+    if (count < 0) {
+        PyBuffer_Release(&data);
+        return PyErr_NoMemory();
+    }
+
+    PyObject* result = PyList_New(count);
+    if (result == NULL) {
+        goto done;
+    }
+
+    for (Py_ssize_t i = 0; i < count; i++) {
+        PyObject* graph = graphFromG6(type, (const char*)data.buf + starts[i], lengths[i]);
+        if (graph == NULL) {
+            Py_CLEAR(result);
+            goto done;
+        }
+        PyList_SET_ITEM(result, i, graph);
+    }
+
+done:
+    free(starts);
+    free(lengths);
+    PyBuffer_Release(&data);
+    return result;
+}
+
+// Strumieniowy odczyt grafw z pliku g6 (take sparse6/digraph6), zwykego, gzip albo zip.
+// Plik jest czytany porcjami o staym rozmiarze do wasnego bufora (readinto, bez kopii),
+// a grafy powstaj pojedynczo w __next__, wic pami nie zaley od rozmiaru korpusu.
+// Bufor ronie tylko wtedy, gdy pojedyncza linia jest dusza od porcji.
+typedef struct {
+    PyObject_HEAD
+    PyTypeObject* structure;
+    PyObject* archive;         // zipfile.ZipFile albo NULL dla zwykego pliku i gzip
+    PyObject* names;           // nazwy plikw archiwum
+    Py_ssize_t member;         // indeks nastpnego pliku archiwum
+    PyObject* stream;          // biecy plik albo NULL po wyczerpaniu danych
+    char* buffer;
+    Py_ssize_t capacity;
+    Py_ssize_t start;          // pocztek nieprzetworzonych danych
+    Py_ssize_t end;            // koniec danych w buforze
+    int eof;                   // biecy plik zosta przeczytany do koca
+} G6Reader;
+
+#define G6_READER_CHUNK (1 << 20)
+
+static int g6ReaderCloseStream(G6Reader* self) {
+    if (self->stream == NULL) {
+        return 0;
+    }
+
+    PyObject* result = PyObject_CallMethod(self->stream, "close", NULL);
+    Py_CLEAR(self->stream);
+    Py_XDECREF(result);
+    return result == NULL ? -1 : 0;
+}
+
+static PyObject* G6Reader_close(G6Reader* self) {
+    int result = g6ReaderCloseStream(self);
+
+    if (self->archive != NULL) {
+        PyObject* closed = PyObject_CallMethod(self->archive, "close", NULL);
+        Py_CLEAR(self->archive);
+        if (closed == NULL) {
+            return NULL;
+        }
+        Py_DECREF(closed);
+    }
+    if (result < 0) {
+        return NULL;
+    }
+    Py_RETURN_NONE;
+}
+
+static void G6Reader_dealloc(G6Reader* self) {
+    PyObject *type, *value, *traceback;
+    PyErr_Fetch(&type, &value, &traceback);
+
+    PyObject* result = G6Reader_close(self);
+    if (result == NULL) {
+        PyErr_WriteUnraisable((PyObject*)self);
+    }
+    Py_XDECREF(result);
+    PyErr_Restore(type, value, traceback);
+
+    Py_XDECREF(self->structure);
+    Py_XDECREF(self->names);
+    free(self->buffer);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
+
+// Otwiera nastpny plik archiwum. Zwraca 1, 0 gdy plikw ju nie ma, albo -1 przy bdzie.
+static int g6ReaderNextMember(G6Reader* self) {
+    if (g6ReaderCloseStream(self) < 0) {
+        return -1;
+    }
+
+    while (self->archive != NULL && self->member < PyList_GET_SIZE(self->names)) {
+        PyObject* name = PyList_GET_ITEM(self->names, self->member++);
+        Py_ssize_t length;
+        const char* text = PyUnicode_AsUTF8AndSize(name, &length);
+        if (text == NULL) {
+            return -1;
+        }
+        // Katalogi w archiwum nie zawieraj danych
+        if (length > 0 && text[length - 1] == '/') {
+            continue;
+        }
+
+        self->stream = PyObject_CallMethod(self->archive, "open", "O", name);
+        if (self->stream == NULL) {
+            return -1;
+        }
+        self->eof = 0;
+        return 1;
+    }
+    return 0;
+}
+
+// Dopisuje do bufora kolejn porcj biecego pliku, przesuwajc nieprzetworzon reszt
+// na pocztek. Zwraca -1 przy bdzie.
+static int g6ReaderFill(G6Reader* self) {
+    if (self->start > 0) {
+        memmove(self->buffer, self->buffer + self->start, (size_t)(self->end - self->start));
+        self->end -= self->start;
+        self->start = 0;
+    }
+    if (self->end == self->capacity) {
+        char* buffer = (char*)realloc(self->buffer, (size_t)self->capacity * 2);
+        if (buffer == NULL) {
+            PyErr_NoMemory();
+            return -1;
+        }
+        self->buffer = buffer;
+        self->capacity *= 2;
+    }
+
+    PyObject* view = PyMemoryView_FromMemory(self->buffer + self->end, self->capacity - self->end, PyBUF_WRITE);
+    if (view == NULL) {
+        return -1;
+    }
+    PyObject* result = PyObject_CallMethod(self->stream, "readinto", "O", view);
+    Py_DECREF(view);
+    if (result == NULL) {
+        return -1;
+    }
+
+    Py_ssize_t read = PyLong_AsSsize_t(result);
+    Py_DECREF(result);
+    if (read < 0) {
+        return PyErr_Occurred() ? -1 : 0;
+    }
+    if (read == 0) {
+        self->eof = 1;
+    }
+    self->end += read;
+    return 0;
+}
+
+static PyObject* G6Reader_next(G6Reader* self) {
+    while (self->stream != NULL) {
+        const char* data = self->buffer + self->start;
+        Py_ssize_t available = self->end - self->start;
+        const char* lineEnd = memchr(data, '\n', (size_t)available);
+
+        if (lineEnd == NULL && !self->eof) {
+            if (g6ReaderFill(self) < 0) {
+                return NULL;
+            }
+            continue;
+        }
+
+        // Koniec pliku koczy te ostatni lini, nawet bez znaku nowej linii
+        Py_ssize_t length = lineEnd != NULL ? lineEnd - data : available;
+        self->start += lineEnd != NULL ? length + 1 : length;
+
+        const char* line = data;
+        length = trimG6Line(&line, length);
+        if (length > 0) {
+            return graphFromG6(self->structure, line, length);
+        }
+
+        if (lineEnd == NULL && g6ReaderNextMember(self) < 0) {
+            return NULL;
+        }
+    }
+    return NULL;
+}
+
+static PyMethodDef G6Reader_methods[] = {
+    {"close", (PyCFunction)G6Reader_close, METH_NOARGS},
+    {NULL, NULL}
+};
+
+static PyTypeObject G6ReaderType = {
+    PyVarObject_HEAD_INIT(NULL, 0)
+    "simple_graphs.G6Reader",          /* tp_name */
+    sizeof(G6Reader),                  /* tp_basicsize */
+    0,                                 /* tp_itemsize */
+    (destructor)G6Reader_dealloc,      /* tp_dealloc */
+    0,                                 /* tp_vectorcall_offset */
+    0,                                 /* tp_getattr */
+    0,                                 /* tp_setattr */
+    0,                                 /* tp_as_async */
+    0,                                 /* tp_repr */
+    0,                                 /* tp_as_number */
+    0,                                 /* tp_as_sequence */
+    0,                                 /* tp_as_mapping */
+    0,                                 /* tp_hash */
+    0,                                 /* tp_call */
+    0,                                 /* tp_str */
+    0,                                 /* tp_getattro */
+    0,                                 /* tp_setattro */
+    0,                                 /* tp_as_buffer */
+    Py_TPFLAGS_DEFAULT,                /* tp_flags */
+    0,                                 /* tp_doc */
+    0,                                 /* tp_traverse */
+    0,                                 /* tp_clear */
+    0,                                 /* tp_richcompare */
+    0,                                 /* tp_weaklistoffset */
+    PyObject_SelfIter,                 /* tp_iter */
+    (iternextfunc)G6Reader_next,       /* tp_iternext */
+    G6Reader_methods,                  /* tp_methods */
+};
+
+// Otwiera plik z grafami i zwraca iterator po nich. Rodzaj pliku jest rozpoznawany
+// po pierwszych bajtach: gzip (1f 8b), zip ("PK\3\4") albo zwyky tekst.
+static PyObject* iter_g6(PyObject* module, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "path", "structure", "chunk_size", NULL };
+    PyObject* path;
+    PyTypeObject* type = &AdjacencyListType;
+    Py_ssize_t chunk = G6_READER_CHUNK;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!n", kwlist, &path, &PyType_Type, &type, &chunk)) {
+        return NULL;
+    }
+    if (!isGraphType(type)) {
+        PyErr_SetString(PyExc_TypeError, "Nieobsugiwana struktura grafu");
+        return NULL;
+    }
+    if (chunk <= 0) {
+        PyErr_SetString(PyExc_ValueError, "Rozmiar porcji musi by dodatni");
+        return NULL;
+    }
+
+    G6Reader* self = PyObject_New(G6Reader, &G6ReaderType);
+    if (self == NULL) {
+        return NULL;
+    }
+    Py_INCREF(type);
+    self->structure = type;
+    self->archive = NULL;
+    self->names = NULL;
+    self->member = 0;
+    self->stream = NULL;
+    self->capacity = chunk < 4 ? 4 : chunk;
+    self->start = 0;
+    self->end = 0;
+    self->eof = 0;
+    self->buffer = (char*)malloc((size_t)self->capacity);
+    if (self->buffer == NULL) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
+    }
+
+    PyObject* io = PyImport_ImportModule("io");
+    if (io == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+    self->stream = PyObject_CallMethod(io, "open", "Os", path, "rb");
+    Py_DECREF(io);
+    if (self->stream == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    // Pierwsza porcja trafia do bufora; dla plikw skompresowanych jest potem porzucana
+    while (self->end < 4 && !self->eof) {
+        if (g6ReaderFill(self) < 0) {
+            Py_DECREF(self);
+            return NULL;
+        }
     }
 
-    Node* current = self->adj_list[vertex];
+    const char* magic = self->buffer;
+    const char* moduleName = NULL;
+    if (self->end >= 2 && memcmp(magic, "\x1f\x8b", 2) == 0) {
+        moduleName = "gzip";
+    }
+    else if (self->end >= 4 && memcmp(magic, "PK\x03\x04", 4) == 0) {
+        moduleName = "zipfile";
+    }
 
-    while (current != NULL) {
-        int neighbor = current->vertex;
-        if (neighbor == vertex) {
-            current = current->next;
-            continue;
+    if (moduleName != NULL) {
+        self->start = self->end = 0;
+        self->eof = 0;
+        if (g6ReaderCloseStream(self) < 0) {
+            Py_DECREF(self);
+            return NULL;
         }
-        
-        PyObject* neighbor_py = PyLong_FromLong(neighbor);
 
-        if (neighbor_py == NULL) {
-            Py_DECREF(neighbors_set);
-            PyErr_SetString(PyExc_RuntimeError, "Nie udao si utworzy obiektu ssiada");
+        PyObject* compression = PyImport_ImportModule(moduleName);
+        if (compression == NULL) {
+            Py_DECREF(self);
             return NULL;
         }
+        if (strcmp(moduleName, "gzip") == 0) {
+            self->stream = PyObject_CallMethod(compression, "open", "Os", path, "rb");
+        }
+        else {
+            self->archive = PyObject_CallMethod(compression, "ZipFile", "O", path);
+        }
+        Py_DECREF(compression);
 
-        int result = PySet_Add(neighbors_set, neighbor_py);
-        Py_DECREF(neighbor_py);
-
-        if (result < 0) {
-            Py_DECREF(neighbors_set);
-            PyErr_SetString(PyExc_RuntimeError, "Nie udao si doda ssiada do zbioru ssiadw");
+        if (self->archive != NULL) {
+            self->names = PyObject_CallMethod(self->archive, "namelist", NULL);
+            if (self->names == NULL || !PyList_Check(self->names) || g6ReaderNextMember(self) < 0) {
+                Py_DECREF(self);
+                return NULL;
+            }
+        }
+        else if (self->stream == NULL) {
+            Py_DECREF(self);
             return NULL;
         }
-
-        current = current->next;
     }
 
-    return neighbors_set;
+    return (PyObject*)self;
 }
 
-static PyObject* add_vertex(AdjacencyList* self, PyObject* args) {
-    int vertex;
+// Zwraca dugo zapisu g6 grafu albo -1, gdy obiekt nie jest grafem.
+static Py_ssize_t graphG6Length(PyObject* graph) {
+    if (PyObject_TypeCheck(graph, &AdjacencyListType)) {
+        return g6Length(adjacencyListOrder((AdjacencyList*)graph));
+    }
+    if (PyObject_TypeCheck(graph, &AdjacencyMatrixType)) {
+        return g6Length(POPCOUNT64(((AdjacencyMatrix*)graph)->vertices));
+    }
+    if (PyObject_TypeCheck(graph, &CSRGraphType)) {
+        return csrG6Length((CSRGraph*)graph);
+    }
+    return -1;
+}
 
-    if (!PyArg_ParseTuple(args, "i", &vertex)) {
+// Koduje list grafw (dowolnych obsugiwanych typw) do jednego bufora g6,
+// po jednym grafie w linii (grafy skierowane w formacie digraph6). Wynik mona
+// przekaza wprost do parse_g6_batch.
+static PyObject* dump_g6_batch(PyObject* module, PyObject* graphs) {
+    PyObject* sequence = PySequence_Fast(graphs, "Oczekiwano sekwencji grafw");
+    if (sequence == NULL) {
         return NULL;
     }
 
-    if (vertex < 0 || vertex >= 16) {
-        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
-        return NULL;
+    Py_ssize_t count = PySequence_Fast_GET_SIZE(sequence);
+    PyObject** items = PySequence_Fast_ITEMS(sequence);
+    Py_ssize_t* lengths = (Py_ssize_t*)malloc(((size_t)count + 1) * sizeof(Py_ssize_t));
+    if (lengths == NULL) {
+        Py_DECREF(sequence);
+        return PyErr_NoMemory();
     }
 
-    if (self->adj_list[vertex] != NULL) {
-        PyErr_SetString(PyExc_ValueError, "Wierzchoek ju istnieje w grafie");
-        return NULL;
+    PyObject* result = NULL;
+    Py_ssize_t total = 0;
+    for (Py_ssize_t i = 0; i < count; i++) {
+        lengths[i] = graphG6Length(items[i]);
+        if (lengths[i] < 0) {
+            PyErr_SetString(PyExc_TypeError, "Nieobsugiwana struktura grafu");
+            goto done;
+        }
+        total += lengths[i] + 1;
     }
 
-    Node* newNode = createNode(vertex);
-    if (newNode == NULL) {
-        return NULL;  
+    result = PyBytes_FromStringAndSize(NULL, total);
+    if (result == NULL) {
+        goto done;
     }
-    self->adj_list[vertex] = newNode;
 
-    Py_INCREF(Py_None);
-    return Py_None;
+    char* out = PyBytes_AS_STRING(result);
+    for (Py_ssize_t i = 0; i < count; i++) {
+        if (PyObject_TypeCheck(items[i], &AdjacencyListType)) {
+            AdjacencyList* graph = (AdjacencyList*)items[i];
+            if (adjacencyListWriteG6(graph, out, adjacencyListOrder(graph)) < 0) {
+                Py_CLEAR(result);
+                PyErr_NoMemory();
+                goto done;
+            }
+        }
+        else if (PyObject_TypeCheck(items[i], &AdjacencyMatrixType)) {
+            adjacencyMatrixWriteG6((AdjacencyMatrix*)items[i], out);
+        }
+        else {
+            csrWriteG6((CSRGraph*)items[i], out);
+        }
+        out += lengths[i];
+        *out++ = '\n';
+    }
+
+done:
+    free(lengths);
+    Py_DECREF(sequence);
+    return result;
 }
 
+// Binarny korpus grafw do wielokrotnego uytku. Plik zawiera nagwek, bloki CSR kolejnych
+// grafw i na kocu indeks przesuni blokw, wic Corpus otwiera go przez mmap bez parsowania,
+// a corpus[i] zwraca CSRGraph wskazujcy wprost na stronice pliku (bez kopiowania; procesy
+// korzystajce z tego samego pliku wspdziel pami podrczn systemu).
+//
+// Blok grafu (wyrwnany do 8 bajtw):
+//   int32 n, int32 directed, int64 offsets[n + 1], int32 targets[offsets[n]], dopenienie.
+// Liczby s zapisane w kolejnoci bajtw maszyny, ktra utworzya plik.
+#define CORPUS_MAGIC "SGCORPUS"
+#define CORPUS_VERSION 1
+#define CORPUS_WRITE_BUFFER (1 << 20)
 
-static PyObject* delete_vertex(AdjacencyList* self, PyObject* args) {
-    int vertex;
+typedef struct {
+    char magic[8];
+    uint32_t version;
+    uint32_t byteOrder;      // 1 zapisane natywnie, inna warto oznacza obc kolejno bajtw
+    uint64_t count;          // liczba grafw
+    uint64_t indexOffset;    // pocztek tablicy count + 1 przesuni blokw
+} CorpusHeader;
 
-    if (!PyArg_ParseTuple(args, "i", &vertex)) {
-        return NULL;
-    }
+typedef struct {
+    PyObject* file;
+    char* buffer;
+    Py_ssize_t used;
+    uint64_t position;       // liczba bajtw zapisanych od pocztku pliku
+} CorpusWriter;
 
-    if (vertex < 0 || vertex >= 16) {
-        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
-        return NULL;
+static int corpusFlush(CorpusWriter* writer) {
+    if (writer->used == 0) {
+        return 0;
     }
 
-    if (self->adj_list[vertex] == NULL) {
-        PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje");
-        return NULL;
+    PyObject* view = PyMemoryView_FromMemory(writer->buffer, writer->used, PyBUF_READ);
+    if (view == NULL) {
+        return -1;
     }
+    PyObject* result = PyObject_CallMethod(writer->file, "write", "O", view);
+    Py_DECREF(view);
+    if (result == NULL) {
+        return -1;
+    }
+    Py_DECREF(result);
+    writer->used = 0;
+    return 0;
+}
 
-    Node* current = self->adj_list[vertex];
-    while (current != NULL) {
-        int neighbor = current->vertex;
-        Node* next = current->next;
-        free(current);
-        self->adj_list[vertex] = NULL;
-        current = next;
+static int corpusWrite(CorpusWriter* writer, const void* data, Py_ssize_t size) {
+    const char* bytes = (const char*)data;
 
-        Node* neighborNode = self->adj_list[neighbor];
-        Node* prev = NULL;
-        while (neighborNode != NULL) {
-            if (neighborNode->vertex == vertex) {
-                if (prev == NULL) {
-                    self->adj_list[neighbor] = neighborNode->next;
-                }
-                else {
-                    prev->next = neighborNode->next;
-                }
-                free(neighborNode);
-                break;
-            }
-            prev = neighborNode;
-            neighborNode = neighborNode->next;
+    writer->position += (uint64_t)size;
+    while (size > 0) {
+        if (writer->used == CORPUS_WRITE_BUFFER && corpusFlush(writer) < 0) {
+            return -1;
+        }
+        Py_ssize_t part = CORPUS_WRITE_BUFFER - writer->used;
+        if (part > size) {
+            part = size;
         }
+        memcpy(writer->buffer + writer->used, bytes, (size_t)part);
+        writer->used += part;
+        bytes += part;
+        size -= part;
     }
-
-    Py_INCREF(Py_None);
-    return Py_None;
+    return 0;
 }
 
+// Zamienia element przekazany do write_corpus na graf CSR (nowa referencja).
+// Przyjmuje grafy wszystkich typw oraz tekst g6/sparse6/digraph6.
+static CSRGraph* corpusGraph(PyObject* item) {
+    if (PyObject_TypeCheck(item, &CSRGraphType)) {
+        Py_INCREF(item);
+        return (CSRGraph*)item;
+    }
+    if (PyObject_TypeCheck(item, &AdjacencyListType)) {
+        return (CSRGraph*)freeze((AdjacencyList*)item);
+    }
 
+    PyObject* text;
+    if (PyObject_TypeCheck(item, &AdjacencyMatrixType)) {
+        text = AdjacencyMatrix_to_g6((AdjacencyMatrix*)item);
+    }
+    else if (PyUnicode_Check(item)) {
+        Py_INCREF(item);
+        text = item;
+    }
+    else if (PyBytes_Check(item)) {
+        return (CSRGraph*)csrFromText(&CSRGraphType, PyBytes_AS_STRING(item), PyBytes_GET_SIZE(item));
+    }
+    else {
+        PyErr_SetString(PyExc_TypeError, "Nieobsugiwana struktura grafu");
+        return NULL;
+    }
+    if (text == NULL) {
+        return NULL;
+    }
 
-static PyObject* number_of_edges(AdjacencyList* self) {
-    int edgeCount = 0;
+    Py_ssize_t length;
+    const char* data = PyUnicode_AsUTF8AndSize(text, &length);
+    CSRGraph* graph = data != NULL ? (CSRGraph*)csrFromText(&CSRGraphType, data, length) : NULL;
+    Py_DECREF(text);
+    return graph;
+}
 
-    for (int i = 0; i < 16; i++) {
-        Node* current = self->adj_list[i];
+static int corpusWriteGraph(CorpusWriter* writer, CSRGraph* graph) {
+    static const char padding[8] = { 0 };
+    int32_t header[2] = { graph->n, graph->directed };
+    Py_ssize_t offsetsSize = ((Py_ssize_t)graph->n + 1) * (Py_ssize_t)sizeof(int64_t);
+    Py_ssize_t targetsSize = (Py_ssize_t)graph->offsets[graph->n] * (Py_ssize_t)sizeof(int32_t);
 
-        while (current != NULL) {
-            if (current->vertex > i) {
-                edgeCount++;
-            }
-            current = current->next;
-        }
+    if (corpusWrite(writer, header, sizeof(header)) < 0 ||
+        corpusWrite(writer, graph->offsets, offsetsSize) < 0 ||
+        corpusWrite(writer, graph->targets, targetsSize) < 0) {
+        return -1;
     }
-
-    return PyLong_FromLong(edgeCount);
+    return corpusWrite(writer, padding, (Py_ssize_t)((8 - writer->position % 8) % 8));
 }
 
-static PyObject* edges(AdjacencyList* self) {
-    PyObject* edges_set = PySet_New(NULL);
+// Zapisuje grafy z dowolnego iterowalnego obiektu (np. iter_g6) do pliku korpusu.
+// Grafy s przetwarzane po jednym; w pamici zostaje tylko indeks (8 bajtw na graf).
+// Zwraca liczb zapisanych grafw.
+static PyObject* write_corpus(PyObject* module, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "path", "graphs", NULL };
+    PyObject* path;
+    PyObject* graphs;
 
-    if (edges_set == NULL) {
-        PyErr_SetString(PyExc_RuntimeError, "Nie mona zaalokowa pamici dla zbioru (set)");
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "OO", kwlist, &path, &graphs)) {
         return NULL;
     }
 
-    for (int u = 0; u < 16; u++) {
-        Node* current = self->adj_list[u];
+    PyObject* iterator = PyObject_GetIter(graphs);
+    if (iterator == NULL) {
+        return NULL;
+    }
 
-        while (current != NULL) {
-            int v = current->vertex;
-            if (u < v) {
-                PyObject* edge_tuple = Py_BuildValue("(ii)", u, v);
-                if (edge_tuple == NULL) {
-                    Py_DECREF(edges_set);
-                    PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas tworzenia krotki (tuple)");
-                    return NULL;
-                }
+    CorpusWriter writer = { NULL, NULL, 0, 0 };
+    uint64_t* index = NULL;
+    uint64_t count = 0, capacity = 1024;
+    PyObject* result = NULL;
+    PyObject* item;
 
-                int result = PySet_Add(edges_set, edge_tuple);
-                Py_DECREF(edge_tuple);
+    PyObject* io = PyImport_ImportModule("io");
+    if (io != NULL) {
+        writer.file = PyObject_CallMethod(io, "open", "Os", path, "wb");
+        Py_DECREF(io);
+    }
+    writer.buffer = (char*)malloc(CORPUS_WRITE_BUFFER);
+    index = (uint64_t*)malloc((size_t)capacity * sizeof(uint64_t));
+    if (writer.file == NULL || writer.buffer == NULL || index == NULL) {
+        if (!PyErr_Occurred()) {
+            PyErr_NoMemory();
+        }
+        goto done;
+    }
 
-                if (result < 0) {
-                    Py_DECREF(edges_set);
-                    PyErr_SetString(PyExc_RuntimeError, "Wystpi nieoczekiwany problem podczas dodawania krotki do zbioru");
-                    return NULL;
-                }
-            }
+    // Nagwek jest uzupeniany na kocu, gdy znana jest liczba grafw
+    CorpusHeader header;
+    memset(&header, 0, sizeof(header));
+    if (corpusWrite(&writer, &header, sizeof(header)) < 0) {
+        goto done;
+    }
 
-            current = current->next;
+    while ((item = PyIter_Next(iterator)) != NULL) {
+        CSRGraph* graph = corpusGraph(item);
+        Py_DECREF(item);
+        if (graph == NULL) {
+            goto done;
         }
-    }
 
-    return edges_set;
-}
+        if (count + 1 == capacity) {
+            uint64_t* newIndex = (uint64_t*)realloc(index, (size_t)capacity * 2 * sizeof(uint64_t));
+            if (newIndex == NULL) {
+                Py_DECREF(graph);
+                PyErr_NoMemory();
+                goto done;
+            }
+            index = newIndex;
+            capacity *= 2;
+        }
+        index[count++] = writer.position;
 
+        int written = corpusWriteGraph(&writer, graph);
+        Py_DECREF(graph);
+        if (written < 0) {
+            goto done;
+        }
+    }
+    if (PyErr_Occurred()) {
+        goto done;
+    }
 
-static PyObject* is_edge(AdjacencyList* self, PyObject* args) {
-    int u, v;
+    index[count] = writer.position;
+    memcpy(header.magic, CORPUS_MAGIC, sizeof(header.magic));
+    header.version = CORPUS_VERSION;
+    header.byteOrder = 1;
+    header.count = count;
+    header.indexOffset = writer.position;
 
-    if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
-        return NULL;
+    if (corpusWrite(&writer, index, (Py_ssize_t)((count + 1) * sizeof(uint64_t))) < 0 || corpusFlush(&writer) < 0) {
+        goto done;
     }
 
-    if (u < 0 || u >= 16 || v < 0 || v >= 16) {
-        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
-        return NULL;
+    PyObject* seek = PyObject_CallMethod(writer.file, "seek", "i", 0);
+    if (seek == NULL) {
+        goto done;
+    }
+    Py_DECREF(seek);
+    if (corpusWrite(&writer, &header, sizeof(header)) < 0 || corpusFlush(&writer) < 0) {
+        goto done;
     }
 
-    Node* current = self->adj_list[u];
-    while (current != NULL) {
-        if (current->vertex == v) {
-            return PyBool_FromLong(1);
+    result = PyLong_FromUnsignedLongLong(count);
+
+done:
+    if (writer.file != NULL) {
+        // Zamknicie pliku nie moe nadpisa wczeniejszego wyjtku
+        PyObject *type, *value, *traceback;
+        PyErr_Fetch(&type, &value, &traceback);
+        PyObject* closed = PyObject_CallMethod(writer.file, "close", NULL);
+        if (closed == NULL) {
+            Py_CLEAR(result);
         }
-        current = current->next;
+        if (type != NULL) {
+            PyErr_Clear();
+            PyErr_Restore(type, value, traceback);
+        }
+        Py_XDECREF(closed);
+        Py_DECREF(writer.file);
     }
-
-    PyBool_FromLong(0);
+    free(writer.buffer);
+    free(index);
+    Py_DECREF(iterator);
+    return result;
 }
 
+// Korpus otwarty przez mmap. Trzyma bufor caego pliku; kady graf zwrcony przez
+// corpus[i] trzyma wasny bufor, wic pozostaje wany take po zamkniciu korpusu.
+typedef struct {
+    PyObject_HEAD
+    Py_buffer data;            // cay plik (obiekt mmap)
+    const CorpusHeader* header;
+    const uint64_t* index;
+    unsigned char* checked;    // bit i: blok grafu i zosta ju sprawdzony w caoci
+} Corpus;
+
+static void Corpus_dealloc(Corpus* self) {
+    if (self->data.obj != NULL) {
+        PyBuffer_Release(&self->data);
+    }
+    free(self->checked);
+    Py_TYPE(self)->tp_free((PyObject*)self);
+}
 
-static PyObject* add_edge(AdjacencyList* self, PyObject* args) {
-    int src, dest;
+static PyObject* Corpus_new(PyTypeObject* type, PyObject* args, PyObject* kwds) {
+    static char* kwlist[] = { "path", NULL };
+    PyObject* path;
 
-    if (!PyArg_ParseTuple(args, "ii", &src, &dest)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O", kwlist, &path)) {
         return NULL;
     }
 
-    if (src < 0 || src >= 16 || dest < 0 || dest >= 16) {
-        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+    Corpus* self = (Corpus*)type->tp_alloc(type, 0);
+    if (self == NULL) {
         return NULL;
     }
 
-    addEdge(self, src, dest);
-
-    return PyBool_FromLong(1);
-}
-
-int deleteNode(Node** head, int key) {
-    Node* temp = *head;
-    Node* prev = NULL;
+    PyObject* io = PyImport_ImportModule("io");
+    PyObject* mmapModule = PyImport_ImportModule("mmap");
+    PyObject* file = NULL;
+    PyObject* fileno = NULL;
+    PyObject* options = NULL;
+    PyObject* map = NULL;
 
-    while (temp != NULL && temp->vertex != key) {
-        prev = temp;
-        temp = temp->next;
+    if (io != NULL && mmapModule != NULL) {
+        file = PyObject_CallMethod(io, "open", "Os", path, "rb");
     }
-
-    if (temp == NULL) {
-        return 0;
+    if (file != NULL) {
+        fileno = PyObject_CallMethod(file, "fileno", NULL);
     }
-
-    if (prev == NULL) {
-        *head = temp->next;
+    if (fileno != NULL) {
+        // Argument access jest przekazywany po nazwie, bo kolejno argumentw
+        // pozycyjnych mmap.mmap rni si midzy Windows i Uniksem
+        PyObject* access = PyObject_GetAttrString(mmapModule, "ACCESS_READ");
+        options = access != NULL ? Py_BuildValue("{sN}", "access", access) : NULL;
     }
-    else {
-        prev->next = temp->next;
+    if (options != NULL) {
+        PyObject* mmapArgs = Py_BuildValue("(Oi)", fileno, 0);
+        PyObject* constructor = PyObject_GetAttrString(mmapModule, "mmap");
+        if (mmapArgs != NULL && constructor != NULL) {
+            map = PyObject_Call(constructor, mmapArgs, options);
+        }
+        Py_XDECREF(mmapArgs);
+        Py_XDECREF(constructor);
     }
-
-    free(temp);
-    return 1;
-}
-
-static PyObject* delete_edge(AdjacencyList* self, PyObject* args) {
-    int u, v;
-
-    if (!PyArg_ParseTuple(args, "ii", &u, &v)) {
-        return NULL;
+    if (file != NULL) {
+        // mmap ma wasny uchwyt pliku, wic plik mona od razu zamkn
+        PyObject* closed = PyObject_CallMethod(file, "close", NULL);
+        if (closed == NULL) {
+            Py_CLEAR(map);
+        }
+        Py_XDECREF(closed);
     }
+    Py_XDECREF(io);
+    Py_XDECREF(mmapModule);
+    Py_XDECREF(file);
+    Py_XDECREF(fileno);
+    Py_XDECREF(options);
 
-    if (u < 0 || u >= 16 || v < 0 || v >= 16) {
-        PyErr_SetString(PyExc_ValueError, "Indeks wierzchoka poza zakresem");
+    if (map == NULL) {
+        Py_DECREF(self);
         return NULL;
     }
-
-    if (self->adj_list[u] == NULL || self->adj_list[v] == NULL) {
-        PyErr_SetString(PyExc_ValueError, "Wierzchoek nie istnieje w grafie");
+    int result = PyObject_GetBuffer(map, &self->data, PyBUF_SIMPLE);
+    Py_DECREF(map);
+    if (result < 0) {
+        Py_DECREF(self);
         return NULL;
     }
 
-    int deleted = deleteNode(&(self->adj_list[u]), v);
-    if (!deleted) {
+    self->header = (const CorpusHeader*)self->data.buf;
+    uint64_t size = (uint64_t)self->data.len;
+    if (size < sizeof(CorpusHeader) ||
+        memcmp(self->header->magic, CORPUS_MAGIC, sizeof(self->header->magic)) != 0 ||
+        self->header->version != CORPUS_VERSION || self->header->byteOrder != 1 ||
+        self->header->indexOffset % 8 != 0 || self->header->indexOffset > size ||
+        self->header->count >= (size - self->header->indexOffset) / sizeof(uint64_t)) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawny plik korpusu");
+        Py_DECREF(self);
         return NULL;
     }
-
-    deleted = deleteNode(&(self->adj_list[v]), u);
-    if (!deleted) {
-        return NULL; 
+    self->index = (const uint64_t*)((const char*)self->data.buf + self->header->indexOffset);
+    self->checked = (unsigned char*)calloc((size_t)(self->header->count / 8 + 1), 1);
+    if (self->checked == NULL) {
+        Py_DECREF(self);
+        return PyErr_NoMemory();
     }
 
-    return PyBool_FromLong(1);
+    return (PyObject*)self;
 }
 
-int isBipartiteUtil(AdjacencyList* self, int v, int col[]) {
-    col[v] = 0; // Kolorujemy wierzchoek v na kolor 0
-
-    // kolejka dla BFS
-    int queue[16];
-    int front = 0, rear = 0;
-    queue[rear++] = v;
-
-    while (front < rear) {
-        int u = queue[front++];
-
-        // Przechodzimy przez wszystkich ssiadw wierzchoka u
-        Node* current = self->adj_list[u];
-        while (current != NULL) {
-            int neighbor = current->vertex;
+static Py_ssize_t Corpus_length(Corpus* self) {
+    return (Py_ssize_t)self->header->count;
+}
 
-            if (neighbor != u) {
+// Szuka ssiada w posortowanym wierszu CSR wierzchoka v.
+static int csrRowContains(const int64_t* offsets, const int32_t* targets, int v, int32_t neighbor) {
+    int64_t low = offsets[v], high = offsets[v + 1];
+    while (low < high) {
+        int64_t middle = low + (high - low) / 2;
+        if (targets[middle] < neighbor) {
+            low = middle + 1;
+        }
+        else {
+            high = middle;
+        }
+    }
+    return low < offsets[v + 1] && targets[low] == neighbor;
+}
 
-                // Jeli ssiad nie zosta jeszcze pokolorowany
-                if (col[neighbor] == -1) {
-                    // Kolorujemy ssiada na przeciwny kolor
-                    col[neighbor] = 1 - col[u];
-                    queue[rear++] = neighbor;
-                }
-                // Jeli ssiad ma ten sam kolor co u, to graf nie jest dwudzielny
-                else if (col[neighbor] == col[u]) {
+// Sprawdza, czy tablice CSR bloku opisuj graf: offsets nie malej, zaczynaj si od 0,
+// wszyscy ssiedzi nale do [0, n), wiersze s cile rosnce i bez ptli, a graf
+// nieskierowany jest symetryczny. Pierwsze warunki chroni przed dostpem poza tablicami,
+// pozostae zakadaj operacje CSRGraph (liczenie trjktw, is_tree, to_g6).
+static int corpusBlockValid(int n, int directed, const int64_t* offsets, const int32_t* targets) {
+    if (offsets[0] != 0) {
+        return 0;
+    }
+    for (int v = 0; v < n; v++) {
+        if (offsets[v + 1] < offsets[v]) {
+            return 0;
+        }
+    }
+    for (int v = 0; v < n; v++) {
+        for (int64_t i = offsets[v]; i < offsets[v + 1]; i++) {
+            if (targets[i] < 0 || targets[i] >= n || targets[i] == v || (i > offsets[v] && targets[i - 1] >= targets[i])) {
+                return 0;
+            }
+        }
+    }
+    if (!directed) {
+        for (int v = 0; v < n; v++) {
+            for (int64_t i = offsets[v]; i < offsets[v + 1]; i++) {
+                if (!csrRowContains(offsets, targets, targets[i], v)) {
                     return 0;
                 }
             }
-            current = current->next;
         }
     }
-
-    return 1; 
+    return 1;
 }
 
-static PyObject* is_bipartite(AdjacencyList* self) {
-    int col[16];
+// Zwraca graf numer i jako CSRGraph korzystajcy bezporednio z pamici pliku. Otwarcie
+// korpusu jest O(1); zawarto bloku sprawdzamy przy pierwszym dostpie do grafu.
+static PyObject* Corpus_item(Corpus* self, Py_ssize_t i) {
+    if (i < 0 || (uint64_t)i >= self->header->count) {
+        PyErr_SetString(PyExc_IndexError, "Indeks grafu poza zakresem");
+        return NULL;
+    }
 
-    // Inicjalizujemy tablic kolorw na -1
-    for (int i = 0; i < 16; i++) {
-        col[i] = -1;
+    uint64_t begin = self->index[i], end = self->index[i + 1];
+    const char* block = (const char*)self->data.buf + begin;
+    const int32_t* blockHeader = (const int32_t*)block;
+    if (begin % 8 != 0 || begin > end || end > self->header->indexOffset || end - begin < 2 * sizeof(int32_t) ||
+        blockHeader[0] < 0 || (uint64_t)blockHeader[0] + 1 > (end - begin - 8) / sizeof(int64_t)) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawny plik korpusu");
+        return NULL;
     }
 
-    // Sprawdzamy wszystkie skadowe grafu
-    for (int i = 0; i < 16; i++) {
-        if (col[i] == -1) {
-            if (!isBipartiteUtil(self, i, col)) {
-                Py_RETURN_FALSE;
-                return PyBool_FromLong(0);
-            }
+    int n = blockHeader[0];
+    const int64_t* offsets = (const int64_t*)(block + 8);
+    uint64_t available = (end - begin - 8 - ((uint64_t)n + 1) * sizeof(int64_t)) / sizeof(int32_t);
+    const int32_t* targets = (const int32_t*)(offsets + n + 1);
+    if (offsets[n] < 0 || (uint64_t)offsets[n] > available || (blockHeader[1] != 0 && blockHeader[1] != 1)) {
+        PyErr_SetString(PyExc_ValueError, "Niepoprawny plik korpusu");
+        return NULL;
+    }
+    if (!(self->checked[i / 8] & (1 << (i % 8)))) {
+        if (!corpusBlockValid(n, blockHeader[1], offsets, targets)) {
+            PyErr_SetString(PyExc_ValueError, "Niepoprawny plik korpusu");
+            return NULL;
         }
+        self->checked[i / 8] |= (unsigned char)(1 << (i % 8));
     }
 
-    return PyBool_FromLong(1);
+    CSRGraph* graph = (CSRGraph*)CSRGraphType.tp_alloc(&CSRGraphType, 0);
+    if (graph == NULL) {
+        return NULL;
+    }
+    if (PyObject_GetBuffer(self->data.obj, &graph->data, PyBUF_SIMPLE) < 0) {
+        Py_DECREF(graph);
+        return NULL;
+    }
+    graph->offsets = offsets;
+    graph->targets = targets;
+    graph->n = n;
+    graph->directed = blockHeader[1];
+    return (PyObject*)graph;
 }
 
-static PyMethodDef AdjacencyList_methods[] = {
-    {"number_of_vertices", (PyCFunction)number_of_vertices, METH_NOARGS},
-    {"vertices", (PyCFunction)vertices, METH_NOARGS},
-    {"vertex_degree", (PyCFunction)vertex_degree, METH_VARARGS},
-    {"vertex_neighbors", (PyCFunction)vertex_neighbors, METH_VARARGS},
-    {"add_vertex", (PyCFunction)add_vertex, METH_VARARGS},
-    {"delete_vertex", (PyCFunction)delete_vertex, METH_VARARGS},
-    {"number_of_edges", (PyCFunction)number_of_edges, METH_NOARGS},
-    {"edges", (PyCFunction)edges, METH_NOARGS},
-    {"is_edge", (PyCFunction)is_edge, METH_VARARGS},
-    {"add_edge", (PyCFunction)add_edge, METH_VARARGS},
-    {"delete_edge", (PyCFunction)delete_edge, METH_VARARGS},
-    {"is_bipartite", (PyCFunction)is_bipartite, METH_NOARGS},
-    {NULL, NULL}
+static PySequenceMethods Corpus_as_sequence = {
+    (lenfunc)Corpus_length,            /* sq_length */
+    0,                                 /* sq_concat */
+    0,                                 /* sq_repeat */
+    (ssizeargfunc)Corpus_item,         /* sq_item */
 };
 
-static PyTypeObject AdjacencyListType = {
+static PyTypeObject CorpusType = {
     PyVarObject_HEAD_INIT(NULL, 0)
-    "simple_graphs.AdjacencyList",    /* tp_name */
-    sizeof(AdjacencyList),             /* tp_basicsize */
-    0,                                 /* tp_name */
-    (destructor)AdjacencyList_dealloc, /* tp_dealloc */
+    "simple_graphs.Corpus",            /* tp_name */
+    sizeof(Corpus),                    /* tp_basicsize */
+    0,                                 /* tp_itemsize */
+    (destructor)Corpus_dealloc,        /* tp_dealloc */
     0,                                 /* tp_vectorcall_offset */
     0,                                 /* tp_getattr */
     0,                                 /* tp_setattr */
     0,                                 /* tp_as_async */
     0,                                 /* tp_repr */
     0,                                 /* tp_as_number */
-    0,                                 /* tp_as_sequence */
+    &Corpus_as_sequence,               /* tp_as_sequence */
     0,                                 /* tp_as_mapping */
     0,                                 /* tp_hash */
     0,                                 /* tp_call */
@@ -552,7 +7477,7 @@ static PyTypeObject AdjacencyListType = {
     0,                                 /* tp_weaklistoffset */
     0,                                 /* tp_iter */
     0,                                 /* tp_iternext */
-    AdjacencyList_methods,             /* tp_methods */
+    0,                                 /* tp_methods */
     0,                                 /* tp_members */
     0,                                 /* tp_getset */
     0,                                 /* tp_base */
@@ -560,22 +7485,46 @@ static PyTypeObject AdjacencyListType = {
     0,                                 /* tp_descr_get */
     0,                                 /* tp_descr_set */
     0,                                 /* tp_dictoffset */
-    (initproc)AdjacencyList_init,      /* tp_init */
+    0,                                 /* tp_init */
     0,                                 /* tp_alloc */
-    AdjacencyList_new,                 /* tp_new */
+    Corpus_new,                        /* tp_new */
+};
+
+static PyMethodDef graphmodule_methods[] = {
+    {"parse_g6_batch", (PyCFunction)(void(*)(void))parse_g6_batch, METH_VARARGS | METH_KEYWORDS},
+    {"map_corpus", (PyCFunction)(void(*)(void))map_corpus, METH_VARARGS | METH_KEYWORDS},
+    {"dedupe_isomorphic", (PyCFunction)(void(*)(void))dedupe_isomorphic, METH_VARARGS | METH_KEYWORDS},
+    {"dump_g6_batch", (PyCFunction)dump_g6_batch, METH_O},
+    {"iter_g6", (PyCFunction)(void(*)(void))iter_g6, METH_VARARGS | METH_KEYWORDS},
+    {"write_corpus", (PyCFunction)(void(*)(void))write_corpus, METH_VARARGS | METH_KEYWORDS},
+    {NULL, NULL}
 };
 
 static struct PyModuleDef graphmodule = {
     PyModuleDef_HEAD_INIT,
     "simple_graphs",
     NULL,
-    -1};
+    -1,
+    graphmodule_methods};
 
 PyMODINIT_FUNC PyInit_simple_graphs(void)
 {
     PyObject *m;
+#if PY_VERSION_HEX >= 0x03090000
+    AdjacencyListType.tp_vectorcall = AdjacencyList_vectorcall;
+#endif
     if (PyType_Ready(&AdjacencyListType) < 0)
         return NULL;
+    if (PyType_Ready(&AdjacencyMatrixType) < 0)
+        return NULL;
+    if (PyType_Ready(&CSRGraphType) < 0)
+        return NULL;
+    if (PyType_Ready(&G6ReaderType) < 0)
+        return NULL;
+    if (PyType_Ready(&AdjacencyListIteratorType) < 0)
+        return NULL;
+    if (PyType_Ready(&CorpusType) < 0)
+        return NULL;
 
     m = PyModule_Create(&graphmodule);
     if (m == NULL)
@@ -589,5 +7538,29 @@ PyMODINIT_FUNC PyInit_simple_graphs(void)
         return NULL;
     }
 
+    Py_INCREF(&AdjacencyMatrixType);
+    if (PyModule_AddObject(m, "AdjacencyMatrix", (PyObject *)&AdjacencyMatrixType) < 0)
+    {
+        Py_DECREF(&AdjacencyMatrixType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&CSRGraphType);
+    if (PyModule_AddObject(m, "CSRGraph", (PyObject *)&CSRGraphType) < 0)
+    {
+        Py_DECREF(&CSRGraphType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
+    Py_INCREF(&CorpusType);
+    if (PyModule_AddObject(m, "Corpus", (PyObject *)&CorpusType) < 0)
+    {
+        Py_DECREF(&CorpusType);
+        Py_DECREF(m);
+        return NULL;
+    }
+
     return m;
 }
\ No newline at end of file
@@ -21,6 +21,12 @@ import graphs
 #   a z parametrami ST i OP sprawdza, czy klasa ST prawidłowo implementuje operację dodatkową OP. Dopuszczalne wartości parametru ST można odczytać z tablicy
 #   GRAPH_STRUCTURES, a parametru OP ze słownika GRAPH_OPERATIONS.      
 #
+#   (3) ./test.py -e [TEST]
+#
+#   Wykonuje wszystkie testy rozszerzeń modułu simple_graphs (formaty, korpusy, postać kanoniczna, odległości, generatory
+#   itd.) albo tylko test TEST. Dopuszczalne wartości parametru TEST można odczytać ze słownika EXTENSION_TESTS. Grafy
+#   testowe są generowane przez tester, więc ten tryb nie wymaga pliku graphs.zip.
+#
 # UWAGA! Tester korzysta z modułu tqdm, który nie jest częścią biblioteki standardowej Pythona i musi być osobno zainstalowany. Opis procesu instalacji można
 # znaleźć w dokumentacji tego modułu, dostępnej na stronie https://github.com/tqdm/tqdm.
 
@@ -231,6 +237,533 @@ def test_of_operation_square( structure, g6_sequence ):
         print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
 
 
+# Testy rozszerzeń modułu simple_graphs, które nie są operacjami klasy graphs.Graph. Tam, gdzie
+# to możliwe, wyniki są porównywane z graphs.Graph albo z prostą implementacją wzorcową.
+
+# Zwraca zbiór wierzchołków i zbiór krawędzi (u, v), u < v, grafu dowolnej struktury.
+def vertices_and_edges( g ):
+    return set( g.vertices() ), set( (min( u, v ), max( u, v )) for u, v in g.edges() )
+
+# Koduje w formacie g6 graf o wierzchołkach 0..n-1 (n <= 62) i podanych krawędziach (u, v), u < v.
+def g6_from_edges( n, edges ):
+    bits = [ 1 if (u, v) in edges else 0 for v in range( 1, n ) for u in range( v ) ]
+    bits += [ 0 ] * (-len( bits ) % 6)
+    return chr( n + 63 ) + "".join( chr( 63 + int( "".join( map( str, bits[i:i + 6] ) ), 2 ) ) for i in range( 0, len( bits ), 6 ) )
+
+# Test funkcji parse_g6_batch() dla wszystkich struktur, także dla bufora z nagłówkiem, pustymi liniami,
+# końcami linii CRLF i bez końcowego znaku nowej linii.
+def test_of_extension_parse_g6_batch( g6_sequence ):
+    reference = [ graphs.Graph( g6 ) for g6 in g6_sequence ]
+    for structure in [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix, simple_graphs.CSRGraph ]:
+        for blob in [ "\n".join( g6_sequence ).encode(), (">>graph6<<" + "\r\n\n".join( g6_sequence ) + "\r\n").encode() ]:
+            batch = simple_graphs.parse_g6_batch( blob, structure )
+            if len( batch ) != len( reference ) or any( type( h ) is not structure or g != h for g, h in zip( reference, batch ) ):
+                print_error_and_quit( f"błąd funkcji parse_g6_batch() dla struktury {structure.__name__}" )
+        try:
+            simple_graphs.parse_g6_batch( b"A_\nB", structure )
+            print_error_and_quit( f"parse_g6_batch() nie zgłasza niepoprawnej linii dla struktury {structure.__name__}" )
+        except ValueError:
+            pass
+
+# Test eksportu danych bez kopiowania: adjacency_csr() i edge_array() wszystkich struktur oraz bufora
+# wierszy AdjacencyMatrix. CSR numeruje wierzchołki kolejno w rosnącej kolejności (jak freeze() i to_g6()),
+# a edge_array() zwraca numery wierzchołków, dlatego graf jest też sprawdzany po przenumerowaniu z lukami.
+def test_of_extension_buffers( g6_sequence ):
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g = graphs.Graph( g6 )
+            spread = simple_graphs.AdjacencyList()
+            for v in g.vertices():
+                spread.add_vertex( 3 * v + 1 )
+            spread.add_edges( [ (3 * u + 1, 3 * v + 1) for u, v in g.edges() ] )
+            structures = [ simple_graphs.AdjacencyList( g6 ), spread, spread.freeze(), simple_graphs.CSRGraph( g6 ) ]
+            for h in structures + [ simple_graphs.AdjacencyMatrix( g6 ) ]:
+                pairs = list( h.edge_array() )
+                if set( zip( pairs[0::2], pairs[1::2] ) ) != vertices_and_edges( h )[1] or len( pairs ) != 2 * g.number_of_edges():
+                    g6_sequence.close()
+                    print_error_and_quit( f"błąd funkcji edge_array() dla struktury {type( h ).__name__} i grafu {g6}" )
+            layouts = set( tuple( tuple( array ) for array in h.adjacency_csr() ) for h in structures )
+            offsets, targets = next( iter( layouts ) )
+            arcs = set( (u, targets[i]) for u in range( g.number_of_vertices() ) for i in range( offsets[u], offsets[u + 1] ) )
+            if len( layouts ) != 1 or arcs != g.edges() | set( (v, u) for u, v in g.edges() ):
+                g6_sequence.close()
+                print_error_and_quit( f"różne albo błędne układy adjacency_csr() dla grafu {g6}" )
+            rows = memoryview( simple_graphs.AdjacencyMatrix( g6 ) ).tolist()
+            if set( (u, v) for u in range( len( rows ) ) for v in range( 64 ) if rows[u] >> v & 1 and u < v ) != g.edges():
+                g6_sequence.close()
+                print_error_and_quit( f"błąd bufora wierszy AdjacencyMatrix dla grafu {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test operacji struktury CSRGraph tworzonej z g6 i przez AdjacencyList.freeze().
+def test_of_extension_csr( g6_sequence ):
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g = graphs.Graph( g6 )
+            for h in [ simple_graphs.CSRGraph( g6 ), simple_graphs.AdjacencyList( g6 ).freeze() ]:
+                results = [ (h.number_of_vertices(), g.number_of_vertices()), (h.number_of_edges(), g.number_of_edges()),
+                            (vertices_and_edges( h ), (g.vertices(), g.edges())), (h.is_bipartite(), g.is_bipartite()),
+                            (h.connected_components(), g.connected_components()), (h.number_of_triangles(), g.number_of_triangles()),
+                            (h.degree_sequence(), g.degree_sequence()) ]
+                results += [ (h.vertex_degree( v ), g.vertex_degree( v )) for v in g.vertices() ]
+                results += [ (h.is_edge( u, v ), g.is_edge( u, v )) for u in g.vertices() for v in g.vertices() if u < v ]
+                if g.number_of_vertices() > 0:
+                    results += [ (h.is_tree(), g.is_tree()), (h.is_complete_bipartite(), g.is_complete_bipartite()) ]
+                if any( a != b for a, b in results ):
+                    g6_sequence.close()
+                    print_error_and_quit( f"błędny wynik operacji struktury CSRGraph dla grafu {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test zapisu w formacie g6: to_g6() wszystkich struktur (także dla grafu zmienionego po wczytaniu) i dump_g6_batch().
+def test_of_extension_to_g6( g6_sequence ):
+    structures = [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix, simple_graphs.CSRGraph ]
+    mixed = [ structures[i % 3]( g6 ) for i, g6 in enumerate( g6_sequence ) ]
+    if simple_graphs.dump_g6_batch( mixed ) != ("\n".join( g6_sequence ) + "\n").encode():
+        print_error_and_quit( "błąd funkcji dump_g6_batch()" )
+    try:
+        simple_graphs.dump_g6_batch( [ mixed[0], 1 ] )
+        print_error_and_quit( "dump_g6_batch() nie zgłasza obiektu, który nie jest grafem" )
+    except TypeError:
+        pass
+
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g = graphs.Graph( g6 )
+            if any( structure( g6 ).to_g6() != g6 for structure in structures ):
+                g6_sequence.close()
+                print_error_and_quit( f"błąd funkcji to_g6() dla grafu {g6}" )
+            if g.number_of_vertices() > 0 and g.number_of_vertices() < 62:
+                n = g.number_of_vertices()
+                expected = g6_from_edges( n + 1, g.edges() | { (0, n) } )
+                for structure in [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix ]:
+                    h = structure( g6 )
+                    h.add_edge( 0, n )
+                    if h.to_g6() != expected:
+                        g6_sequence.close()
+                        print_error_and_quit( f"błąd funkcji to_g6() po dodaniu krawędzi dla struktury {structure.__name__} i grafu {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Koduje w formacie digraph6 graf skierowany o wierzchołkach 0..n-1 (n <= 62) i podanych łukach.
+def digraph6_from_arcs( n, arcs ):
+    bits = [ 1 if (u, v) in arcs else 0 for u in range( n ) for v in range( n ) ]
+    bits += [ 0 ] * (-len( bits ) % 6)
+    return "&" + chr( n + 63 ) + "".join( chr( 63 + int( "".join( map( str, bits[i:i + 6] ) ), 2 ) ) for i in range( 0, len( bits ), 6 ) )
+
+# Test formatów sparse6 (zapis i odczyt we wszystkich strukturach, także przez map_corpus) i digraph6 (CSRGraph).
+def test_of_extension_sparse6( g6_sequence ):
+    structures = [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix, simple_graphs.CSRGraph ]
+    texts = [ simple_graphs.AdjacencyList( g6 ).to_sparse6() for g6 in g6_sequence ]
+    if list( simple_graphs.map_corpus( "\n".join( texts ).encode(), "number_of_edges" ) ) != [ graphs.Graph( g6 ).number_of_edges() for g6 in g6_sequence ]:
+        print_error_and_quit( "błąd funkcji map_corpus() dla korpusu sparse6" )
+
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6, text in zip( g6_sequence, texts ):
+            g = graphs.Graph( g6 )
+            for structure in structures:
+                h = structure( text )
+                if h.to_sparse6() != text or vertices_and_edges( h ) != (g.vertices(), g.edges()) or structure( g6 ).to_sparse6() != text:
+                    g6_sequence.close()
+                    print_error_and_quit( f"błąd formatu sparse6 dla struktury {structure.__name__} i grafu {g6}" )
+            arcs = set( (u, v) for u, v in g.edges() if (u + v) % 3 != 0 ) | set( (v, u) for u, v in g.edges() if (u + v) % 2 == 0 )
+            d = simple_graphs.CSRGraph( digraph6_from_arcs( g.number_of_vertices(), arcs ) )
+            if not d.is_directed() or set( d.edges() ) != arcs or d.to_g6() != digraph6_from_arcs( g.number_of_vertices(), arcs ):
+                g6_sequence.close()
+                print_error_and_quit( f"błąd formatu digraph6 dla grafu {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test funkcji iter_g6() dla plików tekstowych, gzip i zip.
+def test_of_extension_iter_g6( g6_sequence ):
+    import gzip
+    import os
+    import tempfile
+
+    blob = "\n".join( g6_sequence ).encode()
+    with tempfile.TemporaryDirectory() as directory:
+        plain, packed, archive = (os.path.join( directory, name ) for name in [ "graphs.g6", "graphs.g6.gz", "graphs.zip" ])
+        with open( plain, "wb" ) as f:
+            f.write( b">>graph6<<" + blob.replace( b"\n", b"\r\n" ) )
+        with gzip.open( packed, "wb" ) as f:
+            f.write( blob )
+        with zipfile.ZipFile( archive, "w" ) as f:
+            f.writestr( "graphs.g6", blob )
+        for path in [ plain, packed, archive ]:
+            for structure in [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix, simple_graphs.CSRGraph ]:
+                for chunk_size in [ 7, 1 << 16 ]:
+                    if [ h.to_g6() for h in simple_graphs.iter_g6( path, structure, chunk_size ) ] != g6_sequence:
+                        print_error_and_quit( f"błąd funkcji iter_g6() dla pliku {os.path.basename( path )} i struktury {structure.__name__}" )
+
+# Test zapisu (write_corpus) i odczytu (Corpus) korpusu binarnego, także uszkodzonego.
+def test_of_extension_corpus( g6_sequence ):
+    import os
+    import struct
+    import tempfile
+
+    with tempfile.TemporaryDirectory() as directory:
+        path = os.path.join( directory, "graphs.sgc" )
+        texts = g6_sequence + [ digraph6_from_arcs( 3, { (0, 1), (1, 2), (2, 0) } ), digraph6_from_arcs( 4, { (3, 0), (0, 3), (1, 2) } ) ]
+        if simple_graphs.write_corpus( path, texts ) != len( texts ):
+            print_error_and_quit( "błąd wyniku funkcji write_corpus()" )
+        corpus = simple_graphs.Corpus( path )
+        if len( corpus ) != len( texts ) or [ h.to_g6() for h in corpus ] != texts:
+            print_error_and_quit( "odczytany korpus różni się od zapisanego" )
+        if any( h.number_of_triangles() != graphs.Graph( g6 ).number_of_triangles() for h, g6 in zip( corpus, g6_sequence ) ):
+            print_error_and_quit( "błąd operacji na grafach korpusu" )
+        del corpus
+
+        # Pierwszy blok to ścieżka 0-1-2-3 ('Ch'): za nagłówkiem pliku (32 bajty) są n i directed,
+        # offsets = [0, 1, 3, 5, 6] od bajtu 40 i targets = [1, 0, 2, 1, 3, 2] od bajtu 80
+        simple_graphs.write_corpus( path, [ "Ch", "Bw" ] )
+        with open( path, "rb" ) as f:
+            data = f.read()
+        damages = [ (80, -50000000, "i"), (80, 4, "i"), (48, 5, "q"), (40, -1, "q"), (36, 7, "i"),
+                    (80, 0, "i"), (84, 2, "i"), (80, 2, "i") ]
+        for position, value, kind in damages:
+            damaged = bytearray( data )
+            struct.pack_into( kind, damaged, position, value )
+            with open( path, "wb" ) as f:
+                f.write( damaged )
+            corpus = simple_graphs.Corpus( path )
+            try:
+                corpus[0].to_g6()
+                print_error_and_quit( f"Corpus nie wykrywa uszkodzenia bloku na pozycji {position} (wartość {value})" )
+            except ValueError:
+                pass
+            if corpus[1].to_g6() != "Bw":
+                print_error_and_quit( "uszkodzenie jednego bloku psuje inne grafy korpusu" )
+            del corpus
+
+# Test spójności liczników (krawędzi, stopni, składowych) AdjacencyList z zawartością grafu,
+# także po nieudanych albo pustych operacjach.
+def test_of_extension_edge_counters( g6_sequence ):
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g, h = graphs.Graph( g6 ), simple_graphs.AdjacencyList( g6 )
+            components = h.connected_components()
+            for u in sorted( g.vertices() ):
+                for v in sorted( g.vertices() ):
+                    if u <= v and not g.is_edge( u, v ):
+                        try:
+                            h.delete_edge( u, v )
+                            g6_sequence.close()
+                            print_error_and_quit( f"delete_edge( {u}, {v} ) nie zgłasza braku krawędzi dla grafu {g6}" )
+                        except ValueError:
+                            pass
+                h.add_edge( u, u )
+                if h.is_edge( u, u ):
+                    g6_sequence.close()
+                    print_error_and_quit( f"is_edge( {u}, {u} ) zgłasza pętlę dla grafu {g6}" )
+            if g != h or h.number_of_edges() != g.number_of_edges() or h.connected_components() != components:
+                g6_sequence.close()
+                print_error_and_quit( f"nieudane operacje zmieniają graf {g6}" )
+            for u in g.vertices():
+                if h.vertex_degree( u ) != g.vertex_degree( u ):
+                    g6_sequence.close()
+                    print_error_and_quit( f"błąd stopnia wierzchołka {u} dla grafu {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test iteratorów iter_neighbors() i iter_edges().
+def test_of_extension_iterators( g6_sequence ):
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g, h = graphs.Graph( g6 ), simple_graphs.AdjacencyList( g6 )
+            if set( (min( u, v ), max( u, v )) for u, v in h.iter_edges() ) != g.edges() or len( list( h.iter_edges() ) ) != g.number_of_edges():
+                g6_sequence.close()
+                print_error_and_quit( f"błąd funkcji iter_edges() dla grafu {g6}" )
+            for u in g.vertices():
+                if set( h.iter_neighbors( u ) ) != g.vertex_neighbors( u ):
+                    g6_sequence.close()
+                    print_error_and_quit( f"błąd funkcji iter_neighbors( {u} ) dla grafu {g6}" )
+            if g.number_of_edges() > 0:
+                iterator = h.iter_edges()
+                h.add_vertex( 100 )
+                try:
+                    next( iterator )
+                    g6_sequence.close()
+                    print_error_and_quit( f"iter_edges() nie wykrywa zmiany grafu {g6}" )
+                except RuntimeError:
+                    pass
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test równości (==, !=) i funkcji skrótu AdjacencyList.
+def test_of_extension_equality( g6_sequence ):
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g = graphs.Graph( g6 )
+            a, b = simple_graphs.AdjacencyList( g6 ), simple_graphs.AdjacencyList()
+            for v in g.vertices():
+                b.add_vertex( v )
+            for u, v in g.edges():
+                b.add_edge( u, v )
+            if not (a == b) or a != b or hash( a ) != hash( b ):
+                g6_sequence.close()
+                print_error_and_quit( f"różne wyniki porównania równych grafów {g6}" )
+
+            # Ten sam graf zbudowany innymi drogami (wierzchołki tworzone przez add_vertex() albo przez krawędzie)
+            c, d = simple_graphs.AdjacencyList(), simple_graphs.AdjacencyList()
+            for u, v in g.edges():
+                c.add_edge( u, v )
+            d.add_edges( sorted( g.edges() ) )
+            for v in g.vertices():
+                if g.vertex_degree( v ) == 0:
+                    c.add_vertex( v )
+                    d.add_vertex( v )
+            for h in [ c, d, simple_graphs.AdjacencyList( a.to_sparse6() ), a.complement().complement() ]:
+                if a != h or not (h == a) or hash( a ) != hash( h ):
+                    g6_sequence.close()
+                    print_error_and_quit( f"różne wyniki porównania grafów {g6} zbudowanych różnymi metodami" )
+            if g.number_of_edges() > 0:
+                u, w = min( g.edges() )[0], g.number_of_vertices()
+                e = simple_graphs.AdjacencyList()
+                for v in (g.vertices() - { u }) | { w }:
+                    e.add_vertex( v )
+                e.add_edges( [ (w if x == u else x, w if y == u else y) for x, y in g.edges() ] )
+                if a.edge_contraction( u, w ) != e or e != a.edge_contraction( u, w ):
+                    g6_sequence.close()
+                    print_error_and_quit( f"różne wyniki porównania grafów {g6} zbudowanych różnymi metodami" )
+            b.add_vertex( 100 )
+            if a == b or not (a != b) or hash( a ) == hash( b ):
+                g6_sequence.close()
+                print_error_and_quit( f"porównanie nie wykrywa dodanego wierzchołka w grafie {g6}" )
+            b.delete_vertex( 100 )
+            if g.number_of_edges() > 0:
+                u, v = min( g.edges() )
+                b.delete_edge( u, v )
+                if a == b:
+                    g6_sequence.close()
+                    print_error_and_quit( f"porównanie nie wykrywa usuniętej krawędzi w grafie {g6}" )
+                b.add_edge( u, v )
+            if a != b or hash( a ) != hash( b ):
+                g6_sequence.close()
+                print_error_and_quit( f"skrót grafu {g6} zależy od historii zmian" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+def reference_distances( g ):
+    vs = sorted( g.vertices() )
+    neighbors = { v: set() for v in vs }
+    for u, v in g.edges():
+        neighbors[u].add( v )
+        neighbors[v].add( u )
+    result = []
+    for s in vs:
+        distance, queue = { s: 0 }, [ s ]
+        for u in queue:
+            for w in neighbors[u]:
+                if w not in distance:
+                    distance[w] = distance[u] + 1
+                    queue.append( w )
+        result += [ distance.get( v, -1 ) for v in vs ]
+    return result
+
+
+# Test zapytań o odległości (distance_matrix, eccentricities, diameter, wiener_index).
+def test_of_extension_distances( g6_sequence ):
+    # Krawędź macierzy do nowego wierzchołka (63) dodaje go do grafu i wszystkie odległości go uwzględniają
+    for g6 in [ "@" ] + g6_sequence[:200]:
+        g, m = graphs.Graph( g6 ), simple_graphs.AdjacencyMatrix( g6 )
+        u = min( g.vertices(), default = None )
+        if u is not None and 63 not in g.vertices():
+            g.add_vertex( 63 )
+            g.add_edge( u, 63 )
+            m.add_edge( u, 63 )
+        for _ in range( 3 ):
+            if list( m.distance_matrix() ) != reference_distances( g ):
+                print_error_and_quit( f"błąd odległości macierzy {g6} z krawędzią do nowego wierzchołka" )
+
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g = graphs.Graph( g6 )
+            n, expected = g.number_of_vertices(), reference_distances( g )
+            rows = [ expected[i * n:(i + 1) * n] for i in range( n ) ]
+            for h in [ simple_graphs.AdjacencyList( g6 ), simple_graphs.AdjacencyMatrix( g6 ), simple_graphs.CSRGraph( g6 ) ]:
+                if list( h.distance_matrix() ) != expected or list( h.distance_matrix( threads = 2 ) ) != expected:
+                    g6_sequence.close()
+                    print_error_and_quit( f"błąd funkcji distance_matrix() dla struktury {type( h ).__name__} i grafu {g6}" )
+                if n > 0 and -1 not in expected:
+                    if (list( h.eccentricities() ) != [ max( row ) for row in rows ] or h.diameter() != max( expected )
+                            or h.wiener_index() != sum( expected ) // 2):
+                        g6_sequence.close()
+                        print_error_and_quit( f"błąd mimośrodów, średnicy albo indeksu Wienera dla grafu {g6}" )
+                elif n > 0:
+                    for query in [ h.eccentricities, h.diameter, h.wiener_index ]:
+                        try:
+                            query()
+                            g6_sequence.close()
+                            print_error_and_quit( f"{query.__name__}() nie zgłasza niespójności grafu {g6}" )
+                        except ValueError:
+                            pass
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+
+# Test funkcji map_corpus() względem operacji klasy graphs.Graph.
+def test_of_extension_map_corpus( g6_sequence ):
+    blob = "\n".join( g6_sequence ).encode()
+    reference = [ graphs.Graph( g6 ) for g6 in g6_sequence ]
+    for op in [ "number_of_vertices", "number_of_edges", "is_bipartite", "number_of_triangles", "connected_components", "is_tree" ]:
+        # graphs.Graph.is_tree() nie obsługuje grafu pustego, który drzewem nie jest
+        expected = [ int( getattr( g, op )() ) if g.number_of_vertices() > 0 or op != "is_tree" else 0 for g in reference ]
+        for threads in [ 1, 0 ]:
+            if list( simple_graphs.map_corpus( blob, op, threads = threads ) ) != expected:
+                print_error_and_quit( f"błąd funkcji map_corpus() dla operacji {op} i {threads} wątków" )
+
+    # Krótka linia sparse6 o 16385 wierzchołkach przekracza limit macierzy bitowych
+    for data, op in [ (blob, "nieznana"), (b"A_\n:~C?@", "number_of_vertices") ]:
+        try:
+            simple_graphs.map_corpus( data, op )
+            print_error_and_quit( f"map_corpus() nie zgłasza błędu dla operacji {op}" )
+        except ValueError:
+            pass
+    if list( simple_graphs.map_corpus( b":~C??", "connected_components" ) ) != [ 16384 ]:
+        print_error_and_quit( "błąd funkcji map_corpus() dla grafu sparse6 o 16384 wierzchołkach" )
+
+# Test add_edges()/delete_edges() względem pojedynczych add_edge()/delete_edge() klasy graphs.Graph.
+def test_of_extension_bulk_edges( g6_sequence ):
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            for structure in [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix ]:
+                g, h = graphs.Graph( g6 ), structure( g6 )
+                vs = sorted( g.vertices() )
+                missing = [ (u, v) for v in vs for u in vs if u < v and not g.is_edge( u, v ) ]
+                for u, v in missing:
+                    g.add_edge( u, v )
+                if h.add_edges( missing + [ (u, u) for u in vs ] ) != len( missing ) or g != h:
+                    g6_sequence.close()
+                    print_error_and_quit( f"błąd funkcji add_edges() dla struktury {structure.__name__} i grafu {g6}" )
+                # Obie struktury odrzucają całe wywołanie z nieistniejącą krawędzią (tu pętlą) i nie zmieniają grafu
+                if missing:
+                    before = h.to_g6()
+                    loop = (missing[0][0], missing[0][0])
+                    for delete in [ lambda: h.delete_edges( [ missing[0], loop ] ), lambda: h.delete_edge( *loop ) ]:
+                        try:
+                            delete()
+                            rejected = False
+                        except ValueError:
+                            rejected = True
+                        if not rejected or h.to_g6() != before or g != h:
+                            g6_sequence.close()
+                            print_error_and_quit( f"błąd delete_edges() / delete_edge() dla nieistniejącej krawędzi w strukturze {structure.__name__} i grafie {g6}" )
+                present = sorted( g.edges() )
+                for u, v in present:
+                    g.delete_edge( u, v )
+                if h.delete_edges( present ) != len( present ) or g != h:
+                    g6_sequence.close()
+                    print_error_and_quit( f"błąd funkcji delete_edges() dla struktury {structure.__name__} i grafu {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test add_edge() i add_edges() macierzy sąsiedztwa dla krawędzi z nieistniejącymi końcami, które
+# są dodawane jako wierzchołki, więc wszystkie operacje widzą ten sam graf.
+def test_of_extension_matrix_edges( g6_sequence ):
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g, h, l = graphs.Graph( g6 ), simple_graphs.AdjacencyMatrix( g6 ), simple_graphs.AdjacencyList( g6 )
+            u = min( g.vertices(), default = 0 )
+            for v in { u, 61, 63 } - g.vertices():
+                g.add_vertex( v )
+            g.add_edge( u, 63 )
+            for x in [ h, l ]:
+                x.add_edge( u, 63 )
+                x.add_edges( [ (61, 61) ] )
+            results = [ (h.to_g6(), l.to_g6()), (h.number_of_edges(), g.number_of_edges()), (h.number_of_triangles(), g.number_of_triangles()),
+                        (h.is_edge( u, 63 ), True), (h.is_edge( 61, 61 ), False) ]
+            if g != h or any( a != b for a, b in results ) or any( h.vertex_degree( v ) != g.vertex_degree( v ) for v in g.vertices() ):
+                g6_sequence.close()
+                print_error_and_quit( f"błąd add_edge() / add_edges() macierzy dla krawędzi z nowym wierzchołkiem w grafie {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test postaci kanonicznej (canonical_g6) i funkcji dedupe_isomorphic().
+def test_of_extension_canonical( g6_sequence ):
+    import itertools
+    import random
+
+    # Liczby klas izomorfizmu grafów o 0..6 wierzchołkach to 1, 1, 2, 4, 11, 34, 156
+    for n, expected in enumerate( [ 1, 1, 2, 4, 11, 34, 156 ] ):
+        pairs = [ (u, v) for v in range( n ) for u in range( v ) ]
+        classes = set( simple_graphs.AdjacencyMatrix( g6_from_edges( n, set( itertools.compress( pairs, mask ) ) ) ).canonical_g6()
+                       for mask in itertools.product( [ 0, 1 ], repeat = len( pairs ) ) )
+        if len( classes ) != expected:
+            print_error_and_quit( f"canonical_g6() daje {len( classes )} klas grafów o {n} wierzchołkach zamiast {expected}" )
+
+    # Za duży graf daje ValueError, także gdy nie mieści się w strukturze pomocniczej (ponad 16384 wierzchołki)
+    for n in [ 65, 16385 ]:
+        empty = "~" + "".join( chr( 63 + (n >> shift & 63) ) for shift in [ 12, 6, 0 ] ) + "?" * ((n * (n - 1) // 2 + 5) // 6)
+        try:
+            simple_graphs.CSRGraph( empty ).canonical_g6()
+            print_error_and_quit( f"canonical_g6() nie zgłasza błędu dla grafu o {n} wierzchołkach" )
+        except ValueError:
+            pass
+
+    blob = "\n".join( g6_sequence ).encode()
+    first = {}
+    for i, g6 in enumerate( g6_sequence ):
+        first.setdefault( simple_graphs.AdjacencyList( g6 ).canonical_g6(), i )
+    if list( simple_graphs.dedupe_isomorphic( blob ) ) != sorted( first.values() ):
+        print_error_and_quit( "błąd funkcji dedupe_isomorphic()" )
+
+    random.seed( 0 )
+    g6_sequence = tqdm.tqdm( g6_sequence )
+    try:
+        for g6 in g6_sequence:
+            g = graphs.Graph( g6 )
+            n = g.number_of_vertices()
+            permutation = random.sample( range( n ), n )
+            relabelled = g6_from_edges( n, set( (min( permutation[u], permutation[v] ), max( permutation[u], permutation[v] )) for u, v in g.edges() ) )
+            canonical = simple_graphs.AdjacencyList( g6 ).canonical_g6()
+            if any( structure( text ).canonical_g6() != canonical for structure in [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix, simple_graphs.CSRGraph ]
+                    for text in [ g6, relabelled ] ) or vertices_and_edges( graphs.Graph( canonical ) )[1].__len__() != g.number_of_edges():
+                g6_sequence.close()
+                print_error_and_quit( f"błąd funkcji canonical_g6() dla grafu {g6}" )
+    except Exception as e:
+        print_error_and_quit( f"podczas testu na grafie {g6} wystąpił wyjątek {e}" )
+
+# Test generatorów grafów losowych (create_gnp, create_gnm, create_random_regular).
+def test_of_extension_random_generators( g6_sequence ):
+    structures = [ simple_graphs.AdjacencyList, simple_graphs.AdjacencyMatrix ]
+    for n in range( 0, 65, 7 ):
+        for seed in range( 5 ):
+            for name, args in [ ("create_gnp", (n, 0.3)), ("create_gnm", (n, n * (n - 1) // 6)), ("create_random_regular", (n, min( 2 * (seed % 3), n - 1 - n % 2 ) if n > 0 else 0)) ]:
+                results = [ getattr( structure, name )( *args, seed = seed ) for structure in structures for _ in range( 2 ) ]
+                if len( set( frozenset( vertices_and_edges( h )[1] ) for h in results ) ) != 1:
+                    print_error_and_quit( f"{name}{args} z ziarnem {seed} nie daje powtarzalnego wyniku" )
+                h = results[0]
+                if set( h.vertices() ) != set( range( n ) ) or any( u == v for u, v in h.edges() ):
+                    print_error_and_quit( f"błędne wierzchołki albo pętle w wyniku {name}{args}" )
+                if name == "create_gnm" and h.number_of_edges() != args[1]:
+                    print_error_and_quit( f"{name}{args} daje {h.number_of_edges()} krawędzi" )
+                if name == "create_random_regular" and any( h.vertex_degree( v ) != args[1] for v in range( n ) ):
+                    print_error_and_quit( f"{name}{args} nie daje grafu regularnego" )
+        for structure in structures:
+            if (structure.create_gnp( n, 1.0 ).number_of_edges() != n * (n - 1) // 2 or structure.create_gnp( n, 0.0 ).number_of_edges() != 0
+                    or structure.create_gnm( n, n * (n - 1) // 2 ).number_of_edges() != n * (n - 1) // 2):
+                print_error_and_quit( f"błąd generatora dla skrajnych parametrów i {n} wierzchołków" )
+    for structure in structures:
+        # Także konstruktor grafu pełnego dwudzielnego, gdy n + m nie mieści się w int
+        for name, args in [ ("create_gnp", (5, 1.5)), ("create_gnm", (5, 11)), ("create_random_regular", (5, 3)), ("create_random_regular", (4, 4)),
+                            ("create_complete_bipartite", (2 ** 31 - 1, 1)), ("create_complete_bipartite", (1, 2 ** 31 - 1)) ]:
+            try:
+                getattr( structure, name )( *args )
+                print_error_and_quit( f"{name}{args} nie zgłasza niepoprawnych parametrów" )
+            except ValueError:
+                pass
+
+
 # Struktury grafów, które tester akceptuje.
 GRAPH_STRUCTURES = [ "AdjacencyMatrix", "AdjacencyList", "EdgesList", "IncidenceMatrix" ]
 
@@ -254,6 +787,26 @@ GRAPH_OPERATIONS = {
     "square":                    test_of_operation_square,
 }
 
+# Testy rozszerzeń modułu simple_graphs wraz z przypisanymi im funkcjami testującymi.
+EXTENSION_TESTS = {
+    "buffers":                   test_of_extension_buffers,
+    "bulk_edges":                test_of_extension_bulk_edges,
+    "canonical":                 test_of_extension_canonical,
+    "corpus":                    test_of_extension_corpus,
+    "csr":                       test_of_extension_csr,
+    "distances":                 test_of_extension_distances,
+    "edge_counters":             test_of_extension_edge_counters,
+    "equality":                  test_of_extension_equality,
+    "iter_g6":                   test_of_extension_iter_g6,
+    "iterators":                 test_of_extension_iterators,
+    "map_corpus":                test_of_extension_map_corpus,
+    "matrix_edges":              test_of_extension_matrix_edges,
+    "parse_g6_batch":            test_of_extension_parse_g6_batch,
+    "random_generators":         test_of_extension_random_generators,
+    "sparse6":                   test_of_extension_sparse6,
+    "to_g6":                     test_of_extension_to_g6,
+}
+
 # Wczytuje do pamięci zestawy grafów testowych.
 def read_graphs():
     print( "Przygotowuję dane testowe. Proszę czekać." )
@@ -262,6 +815,23 @@ def read_graphs():
     print( f"Przygotowano {len( g6_sequence )} grafów." )
     return g6_sequence
 
+# Tworzy zestaw grafów dla testów rozszerzeń bez pliku graphs.zip: wszystkie grafy etykietowane
+# o co najwyżej 5 wierzchołkach oraz powtarzalne grafy losowe o 6..62 wierzchołkach.
+def generate_graphs():
+    import itertools
+    import random
+
+    g6_sequence = []
+    for n in range( 6 ):
+        pairs = [ (u, v) for v in range( n ) for u in range( v ) ]
+        g6_sequence += [ g6_from_edges( n, set( itertools.compress( pairs, mask ) ) ) for mask in itertools.product( [ 0, 1 ], repeat = len( pairs ) ) ]
+    generator = random.Random( 2024 )
+    for n in list( range( 6, 31 ) ) + [ 40, 50, 62 ]:
+        for p in [ 0.05, 0.15, 0.3, 0.6, 0.9 ]:
+            g6_sequence.append( g6_from_edges( n, set( (u, v) for v in range( n ) for u in range( v ) if generator.random() < p ) ) )
+    print( f"Przygotowano {len( g6_sequence )} grafów." )
+    return g6_sequence
+
 # Wykonuje test wskazanej struktury.
 def test_structure( structure, g6_sequence ):
     g6_sequence = tqdm.tqdm( g6_sequence )
@@ -402,7 +972,7 @@ def test_structure( structure, g6_sequence ):
             print_error_and_quit( f"podczas testu funkcji add_edge() / delete_edge() dla grafu {g6} wystąpił wyjątek {e}" )
 
 if len( sys.argv ) == 1 or (len( sys.argv ) == 2 and sys.argv[1] in [ "-h", "--help" ]):
-    print( f"Sposób użycia: {sys.argv[0]} [-h|--help|-t [STRUKTURA [OPERACJA]]]" )
+    print( f"Sposób użycia: {sys.argv[0]} [-h|--help|-t [STRUKTURA [OPERACJA]]|-e [TEST]]" )
     print( f"Wiecej informacji znajdziesz w pliku {sys.argv[0]}" )
     exit( 0 )
 elif len( sys.argv ) == 2 and sys.argv[1] == "-t":
@@ -434,5 +1004,16 @@ elif len( sys.argv ) == 4 and sys.argv[1] == "-t" and sys.argv[2] in GRAPH_STRUC
         print_error_and_quit( "moduł simple_graphs nie istnieje" )
     except AttributeError:
         print_error_and_quit( f"moduł simple_graphs nie zawiera struktury {sys.argv[2]} lub ta struktura nie zawiera funkcji {sys.argv[3]}" )
+elif len( sys.argv ) in [ 2, 3 ] and sys.argv[1] == "-e" and (len( sys.argv ) == 2 or sys.argv[2] in EXTENSION_TESTS):
+    try:
+        import simple_graphs
+    except ImportError:
+        print_error_and_quit( "moduł simple_graphs nie istnieje" )
+    g6_sequence = generate_graphs()
+    for t, f in EXTENSION_TESTS.items():
+        if len( sys.argv ) == 2 or sys.argv[2] == t:
+            print( f"Rozpoczynam test rozszerzenia {t}." )
+            s, _, e = time.time(), f( g6_sequence ), time.time()
+            print( f"Test rozszerzenia {t} zakończony sukcesem. Czas trwania testu to {e - s:.2f}s." )
 else:
     print_error_and_quit( f"błędne parametry, wykonaj {sys.argv[0]} -h aby uzyskać pomoc" )